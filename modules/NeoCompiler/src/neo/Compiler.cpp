@@ -2,15 +2,41 @@
 
 #include "neo/base/StringUtils.hpp"
 #include "neo/base/CmdParser.hpp"
+#include "neo/base/Hash.hpp"
 #include "neo/base/Timer.hpp"
 #include "neo/base/Logger.hpp"
+#include "neo/base/MemStats.hpp"
+#include "neo/base/ThreadPool.hpp"
+#include "neo/base/Trace.hpp"
+#include "neo/compiler/Bench.hpp"
+#include "neo/compiler/CompileStats.hpp"
+#include "neo/compiler/DebugOutput.hpp"
+#include "neo/compiler/ModuleGraph.hpp"
 
 #include <iostream>
+#include <unordered_set>
+
+#include <filesystem>
+namespace fs = std::filesystem;
 
 namespace neo {
 
     CompilerConfig NCompiler::s_cfg{
-        .sourceDir = {}
+        .sourceDir = {},
+        .jobs = 0,
+        .cacheDir = {},
+        .timeTrace = {},
+        .memStats = false,
+        .stats = false,
+        .statsJson = {},
+        .asyncLog = false,
+        .dump = {},
+        .dumpDir = "neo_dump",
+        .benchLex = false,
+        .benchParse = false,
+        .benchSize = 0,
+        .benchRuns = 3,
+        .benchInput = {}
     };
 
     NCompiler::NCompiler(int argc, char **argv) {
@@ -27,39 +53,184 @@ namespace neo {
 
     void NCompiler::regFlags(neo::NCmdParser* p) {
         p->regStr("srcDir", s_cfg.sourceDir);
+        p->regU32("jobs", s_cfg.jobs);
+        p->regStr("cacheDir", s_cfg.cacheDir);
+        p->regStr("time-trace", s_cfg.timeTrace);
+        p->regBool("mem-stats", &s_cfg.memStats);
+        p->regBool("stats", &s_cfg.stats);
+        p->regStr("stats-json", s_cfg.statsJson);
+        p->regBool("async-log", &s_cfg.asyncLog);
+        p->regStr("dump", s_cfg.dump);
+        p->regStr("dump-dir", s_cfg.dumpDir);
+        p->regBool("bench-lex", &s_cfg.benchLex);
+        p->regBool("bench-parse", &s_cfg.benchParse);
+        p->regU32("bench-size", s_cfg.benchSize);
+        p->regU32("bench-runs", s_cfg.benchRuns);
+        p->regStr("bench-input", s_cfg.benchInput);
+    }
+
+    u64 NCompiler::configKey() {
+        // everything that changes the artifacts of an unchanged source
+#if NE_DEBUG
+        constexpr std::string_view build = "debug";
+#else
+        constexpr std::string_view build = "release";
+#endif
+        std::string key = std::format("{}|{}|{}|{}|lang {}", NE_NEOC_VERSION, NE_COMPILER_STR, NE_STR,
+                                      build, NSourceFile::kLangVersion);
+        return hashBytes(key);
+    }
+
+    int NCompiler::runBench() {
+        NBench::Options opts {
+            .sizeMB = s_cfg.benchSize,
+            .runs = s_cfg.benchRuns,
+            .input = s_cfg.benchInput,
+        };
+        bool r = true;
+        if (s_cfg.benchLex) {
+            r &= NBench::lex(opts);
+        }
+        if (s_cfg.benchParse) {
+            r &= NBench::parse(opts);
+        }
+        return r ? 0 : 1;
     }
 
     int NCompiler::runCompiler() {
+        if (s_cfg.benchLex || s_cfg.benchParse) {
+            return runBench();
+        }
         if (s_cfg.sourceDir.empty()) {
             LogError("No source dir input! Compiler halt.");
             return 0;
         }
 
+        if (!s_cfg.timeTrace.empty()) {
+            NTrace::enable();
+            NTrace::setThreadName("main");
+        }
+        if (s_cfg.memStats) {
+            NMemStats::enable();
+        }
+        if (s_cfg.stats || !s_cfg.statsJson.empty()) {
+            NCompileStats::enable();
+        }
+        if (!s_cfg.dump.empty() && !NDump::enable(s_cfg.dump, s_cfg.dumpDir)) {
+            LogError("Invalid dump option {}! Compiler halt.", s_cfg.dump);
+            return 0;
+        }
+        if (s_cfg.asyncLog) {
+            getNeoDefaultLogger()->startAsync();
+        }
+        NTraceZone compileZone {"Compile"};
+
         NTimer t{};
         std::vector<std::string> out {};
         splitStr(out, s_cfg.sourceDir, ';');
 
-        for (auto& str : out) {
-            NSourceDir dir {str.c_str()};
-            if (!dir.collect()) {
-                LogDebug("No source file in dir {}", str);
+        // source files point back at their dir, so the dirs must not move after collect
+        m_soruceDirs.reserve(out.size());
+        {
+            NE_TRACE_ZONE("Collect sources");
+            for (auto& str : out) {
+                auto& dir = m_soruceDirs.emplace_back(str.c_str());
+                if (!dir.collect()) {
+                    LogDebug("No source file in dir {}", str);
+                }
             }
-            m_soruceDirs.push_back(std::move(dir));
+        }
+
+        NBuildCache* cache = nullptr;
+        if (!s_cfg.cacheDir.empty()) {
+            std::error_code ec {};
+            fs::create_directories(s_cfg.cacheDir, ec);
+            if (ec) {
+                LogError("Failed to create cache dir {}, caching disabled : {}", s_cfg.cacheDir, ec.message());
+            } else {
+                NE_TRACE_ZONE("Load build cache");
+                m_cache.load(s_cfg.cacheDir, configKey());
+                std::unordered_set<std::string> sources {};
+                for (auto& dir : m_soruceDirs) {
+                    for (psize idx = 0; idx < dir.getSourceCount(); idx++) {
+                        sources.insert(dir.getSource(idx).getPath());
+                    }
+                }
+                m_cache.retain(sources);
+                cache = &m_cache;
+            }
+        }
+
+        // every file of every dir is one job, it starts once the files declaring its imports are built.
+        // Results are reported in dir / path order
+        bool acyclic = true;
+        {
+            NThreadPool pool {NThreadPool::workersForJobs(s_cfg.jobs)};
+            NTraceZone scanZone {"Scan imports"};
+            for (auto& dir : m_soruceDirs) {
+                dir.scan(pool, cache);
+            }
+            pool.wait();
+            scanZone.end();
+
+            NModuleGraph graph {};
+            {
+                NE_TRACE_ZONE("Link modules");
+                for (auto& dir : m_soruceDirs) {
+                    dir.graph(graph);
+                }
+                acyclic = graph.link();
+            }
+            NE_TRACE_ZONE("Build modules");
+            graph.run(pool, [cache](NSourceDir& dir, psize idx) {
+                dir.build(idx, cache);
+            });
         }
 
         bool r = false;
-        for (auto& dir : m_soruceDirs) {
-            r |= dir.compile();
+        {
+            NE_TRACE_ZONE("Report");
+            for (auto& dir : m_soruceDirs) {
+                r |= dir.finish();
+            }
+        }
+        r &= acyclic;
+        {
+            NE_TRACE_ZONE("Write dumps");
+            NDump::finish();
+        }
+
+        if (cache != nullptr) {
+            NE_TRACE_ZONE("Save build cache");
+            cache->save();
         }
 
         // generate process & link process
 
         t.end();
+        compileZone.end();
         if (!r) {
-            LogError("Result occurrenced in compile process! Compiler halt in {} s.", t.secondTime());
+            LogError("Result occurrenced in compile process! Compiler halt in {} ms.", t.milliTime());
         } else {
-            LogInfo("Compiler process end in {} s.", t.secondTime());
+            LogInfo("Compiler process end in {} ms.", t.milliTime());
+        }
+        if (NCompileStats::enabled()) {
+            NCompileCounters counters = NCompileStats::merged();
+            double wallSeconds = (double)t.nanoTime() / 1e9;
+            if (s_cfg.stats) {
+                NCompileStats::report(counters, wallSeconds);
+            }
+            if (!s_cfg.statsJson.empty()) {
+                NCompileStats::writeJson(counters, wallSeconds, s_cfg.statsJson.c_str());
+            }
+        }
+        if (s_cfg.memStats) {
+            NMemStats::report();
+        }
+        if (NTrace::enabled()) {
+            NTrace::write(s_cfg.timeTrace.c_str());
         }
+        getNeoDefaultLogger()->stopAsync();
 
         return 0;
     }
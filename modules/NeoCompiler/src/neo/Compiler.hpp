@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "neo/compiler/BuildCache.hpp"
 #include "neo/compiler/SourceDir.hpp"
 
 #include <string>
@@ -12,6 +13,31 @@ namespace neo {
     struct CompilerConfig
     {
         std::string sourceDir;
+        /// parallel compile jobs, 0 picks one per hardware thread
+        u32 jobs = 0;
+        /// build cache directory, unchanged files are skipped. Empty disables caching
+        std::string cacheDir;
+        /// Chrome trace json of the compile phases, empty disables tracing
+        std::string timeTrace;
+        /// log memory per structure and the files with the highest peaks at the end
+        bool memStats = false;
+        /// log throughput and counters of the compile phases at the end
+        bool stats = false;
+        /// the same counters as json, empty writes none
+        std::string statsJson;
+        /// format and write log lines on a background thread
+        bool asyncLog = false;
+        /// comma separated debug dumps per compiled file : tokens, ast. Empty dumps nothing
+        std::string dump;
+        /// where the dumps go
+        std::string dumpDir;
+        /// run the lexer / parser benchmark instead of compiling
+        bool benchLex = false;
+        bool benchParse = false;
+        /// generated input size in MB (0 is the default of each benchmark), runs per benchmark and the sample file to repeat
+        u32 benchSize = 0;
+        u32 benchRuns = 3;
+        std::string benchInput;
     };
 
 
@@ -25,10 +51,14 @@ namespace neo {
 
     private:
         static void regFlags(NCmdParser*);
+        /// key of the compiler build and flags, cached artifacts from another key are not reused
+        static u64 configKey();
+        static int runBench();
 
     private:
         static CompilerConfig s_cfg;
 
         std::vector<NSourceDir> m_soruceDirs;
+        NBuildCache m_cache;
     };
 }
\ No newline at end of file
@@ -31,7 +31,8 @@ namespace neo {
         "kReturn",
         "kBreak",
         "kContinue",
-        "kImport"
+        "kImport",
+        "kDecl"
     };
     std::string_view getTypeString(StmtKind type) {
         return s_StmtKindStrings[(int)type];
@@ -105,13 +106,6 @@ namespace neo {
     }
 
 
-    ASTDecl::~ASTDecl() {
-        for (auto* ptr : attributes) {
-            delete ptr;
-        }
-        attributes.clear();
-    }
-
     void ASTDecl::write(NSerializer *s) {
         ASTNode::write(s);
 
@@ -203,4 +197,16 @@ namespace neo {
     bool ASTModifier::operator!=(const ASTModifier& other) const noexcept {
         return !(*this == other);
     }
+
+    u8 ASTModifier::pack() const noexcept {
+        return (u8)(isStatic << 0 | isFinal << 1 | isConst << 2 | isPrivate << 3
+                    | isProtected << 4 | isInternal << 5 | isInline << 6);
+    }
+
+    ASTModifier ASTModifier::unpack(u8 bits) noexcept {
+        return ASTModifier {
+            (bits & 1 << 0) != 0, (bits & 1 << 1) != 0, (bits & 1 << 2) != 0, (bits & 1 << 3) != 0,
+            (bits & 1 << 4) != 0, (bits & 1 << 5) != 0, (bits & 1 << 6) != 0
+        };
+    }
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "neo/common.hpp"
 #include "neo/diagnose/SourceLoc.hpp"
 #include "neo/base/Serializer.hpp"
+#include "neo/base/Arena.hpp"
+#include "neo/base/Interner.hpp"
 
 namespace neo {
 
@@ -25,10 +27,16 @@ namespace neo {
     std::string_view getTypeString(ASTType);
 
 
+    /// Child array of an AST node, allocated from the arena of the file being parsed
+    template <typename T>
+    using ASTList = std::vector<T, NArenaAllocator<T>>;
+
+
     struct Attribute {
-        std::string name;
-        std::vector<class ASTExpr*> arguments;
+        NSymbol name;
+        ASTList<class ASTExpr*> arguments;
     };
+    using AttributeList = ASTList<Attribute*>;
 
 
     class ASTNode : public ISerializable
@@ -50,7 +58,7 @@ namespace neo {
             return m_type;
         }
         
-        SourceLoc m_loc;
+        SourceLoc m_loc {};
 
     private:
         ASTType m_type;
@@ -89,7 +97,6 @@ namespace neo {
         NE_FORCE_INLINE StmtKind getStmtKind() const {
             return m_kind;
         }
-        virtual void visit(class ASTVisitor& visitor) {}
 
     private:
         const StmtKind m_kind;
@@ -167,6 +174,10 @@ namespace neo {
 
         bool operator==(const ASTModifier& other) const noexcept;
         bool operator!=(const ASTModifier& other) const noexcept;
+
+        /// one bit per flag in declaration order, the stored form in .nast and .nmd files
+        u8 pack() const noexcept;
+        static ASTModifier unpack(u8 bits) noexcept;
     };
 
 
@@ -177,7 +188,7 @@ namespace neo {
             : ASTNode(ASTType::kDeclaration)
             , m_kind {kind} 
         {}
-        ~ASTDecl() override;
+        ~ASTDecl() override = default;
 
     public:
         NE_FORCE_INLINE DeclKind getDeclKind() const {
@@ -190,8 +201,8 @@ namespace neo {
         void debugPrint(NDebugOutput& output) override;
 
     public:
-        bool isMarkedExport;
-        std::vector<Attribute*> attributes;
+        bool isMarkedExport = false;
+        AttributeList attributes;
 
         ASTModifier modifier;
 
@@ -11,7 +11,7 @@ namespace neo {
     {
     public:
         VarDecl() : ASTDecl(DeclKind::kVar) {}
-        VarDecl(const std::string_view& name, ASTTypeNode* type, ASTExpr* init = nullptr)
+        VarDecl(NSymbol name, ASTTypeNode* type, ASTExpr* init = nullptr)
             : ASTDecl(DeclKind::kVar)
             , name{ name }
             , type{ type }
@@ -26,7 +26,7 @@ namespace neo {
         void write(NSerializer* s) override;
 
     public:
-        std::string name;
+        NSymbol name;
         ASTTypeNode* type = nullptr;
         ASTExpr* initExpr = nullptr;
     };
@@ -36,7 +36,7 @@ namespace neo {
     {
     public:
         FuncDecl() : ASTDecl(DeclKind::kFunc) {}
-        FuncDecl(const std::string_view& name, ASTTypeNode* retType, std::vector<VarDecl*> args, class CompoundStmt* body = nullptr)
+        FuncDecl(NSymbol name, ASTTypeNode* retType, ASTList<VarDecl*> args, class CompoundStmt* body = nullptr)
             : ASTDecl(DeclKind::kFunc)
             , name{ name }
             , args{std::move( args )}
@@ -50,8 +50,8 @@ namespace neo {
         void debugPrint(NDebugOutput& output) override;
 
     public:
-        std::string name;
-        std::vector<VarDecl*> args;
+        NSymbol name;
+        ASTList<VarDecl*> args;
         ASTTypeNode* returnType = nullptr;
         CompoundStmt* funcBody = nullptr;
     };
@@ -62,7 +62,7 @@ namespace neo {
     public:
         FieldDecl()
             : ASTDecl(DeclKind::kField) {}
-        FieldDecl(const std::string_view& name, ASTTypeNode* type, ASTExpr* init = nullptr)
+        FieldDecl(NSymbol name, ASTTypeNode* type, ASTExpr* init = nullptr)
             : ASTDecl(DeclKind::kField)
             , name{ name }
             , type{ type }
@@ -74,9 +74,9 @@ namespace neo {
         ~FieldDecl() override = default;
 
     public:
-        std::string name;
-        std::string setFuncName;
-        std::string getFuncName;
+        NSymbol name;
+        NSymbol setFuncName;
+        NSymbol getFuncName;
         ASTTypeNode* type = nullptr;
         ASTExpr* init = nullptr;
     };
@@ -86,7 +86,7 @@ namespace neo {
     {
     public:
         ClassDecl() : ASTDecl(DeclKind::kClass) {}
-        ClassDecl(const std::string_view& name, std::vector<ASTTypeNode*> baseClasses)
+        ClassDecl(NSymbol name, ASTList<ASTTypeNode*> baseClasses)
             : ASTDecl(DeclKind::kClass)
             , name{ name }
             , baseClasses{std::move( baseClasses )}
@@ -95,13 +95,13 @@ namespace neo {
         ~ClassDecl() override = default;
 
     public:
-        std::string name;
-        std::vector<ASTTypeNode*> baseClasses;
-        std::vector<ASTDecl*> subDataTypes;
-        std::vector<FieldDecl*> fields;
-        std::vector<VarDecl*> variables;
-        std::vector<FuncDecl*> functions;
-        std::vector<FuncDecl*> ctors;
+        NSymbol name;
+        ASTList<ASTTypeNode*> baseClasses;
+        ASTList<ASTDecl*> subDataTypes;
+        ASTList<FieldDecl*> fields;
+        ASTList<VarDecl*> variables;
+        ASTList<FuncDecl*> functions;
+        ASTList<FuncDecl*> ctors;
         FuncDecl* dtors = nullptr;
     };
 
@@ -110,7 +110,7 @@ namespace neo {
     {
     public:
         StructDecl() : ASTDecl(DeclKind::kStruct) {}
-        StructDecl(const std::string_view& name)
+        StructDecl(NSymbol name)
             : ASTDecl(DeclKind::kStruct)
             , name{ name }
         {
@@ -118,9 +118,9 @@ namespace neo {
         ~StructDecl() override = default;
 
     public:
-        std::string name;
-        std::vector<VarDecl*> variables;
-        std::vector<FieldDecl*> fields;
+        NSymbol name;
+        ASTList<VarDecl*> variables;
+        ASTList<FieldDecl*> fields;
     };
 
 
@@ -128,16 +128,16 @@ namespace neo {
     {
     public:
         InterfaceDecl() : ASTDecl(DeclKind::kInterface) {}
-        InterfaceDecl(const std::string_view& name)
+        InterfaceDecl(NSymbol name)
             : ASTDecl(DeclKind::kInterface)
             , name{ name }
         {
         }
-        ~InterfaceDecl() override;
+        ~InterfaceDecl() override = default;
 
     public:
-        std::string name;
-        std::vector<FuncDecl*> children;
+        NSymbol name;
+        ASTList<FuncDecl*> children;
     };
 
 
@@ -145,17 +145,17 @@ namespace neo {
     {
     public:
         EnumDecl() : ASTDecl(DeclKind::kEnum) {}
-        EnumDecl(const std::string_view& name)
+        EnumDecl(NSymbol name)
             : ASTDecl(DeclKind::kEnum)
             , name{ name }
             , baseType{nullptr}
         {
         }
-        ~EnumDecl() override;
+        ~EnumDecl() override = default;
 
     public:
-        std::string name;
-        std::vector<VarDecl*> children;
+        NSymbol name;
+        ASTList<VarDecl*> children;
         ASTTypeNode* baseType = nullptr;
     };
 
@@ -164,15 +164,15 @@ namespace neo {
     {
     public:
         ModuleDecl() : ASTDecl(DeclKind::kModule) {}
-        ModuleDecl(const std::string_view& name)
+        ModuleDecl(NSymbol name)
             : ASTDecl(DeclKind::kModule)
             , name{ name }
         {
         }
-        ~ModuleDecl() override;
+        ~ModuleDecl() override = default;
 
     public:
-        std::string name;
+        NSymbol name;
         class TopLevelDecls* children = nullptr;
     };
 
@@ -181,9 +181,9 @@ namespace neo {
     {
     public:
         TopLevelDecls() : ASTDecl(DeclKind::kTopLevelDecls) {}
-        ~TopLevelDecls() override;
+        ~TopLevelDecls() override = default;
     
     public:
-        std::vector<ASTDecl*> decls;
+        ASTList<ASTDecl*> decls;
     };
 }
\ No newline at end of file
@@ -235,7 +235,7 @@ namespace neo {
     class CallExpr : public ASTExpr
     {
     public:
-        CallExpr(ASTExpr* fTag, std::vector<ASTExpr*> args)
+        CallExpr(ASTExpr* fTag, ASTList<ASTExpr*> args)
             : ASTExpr(ExprKind::kFuncCall)
             , funcTag{ fTag }
             , callArgs{ args }
@@ -253,14 +253,14 @@ namespace neo {
 
     public:
         ASTExpr* funcTag;
-        std::vector<ASTExpr*> callArgs;
+        ASTList<ASTExpr*> callArgs;
     };
 
 
     class MemberAccessExpr : public ASTExpr
     {
     public:
-        MemberAccessExpr(ASTExpr* object, const std::string& member)
+        MemberAccessExpr(ASTExpr* object, NSymbol member)
             : ASTExpr(ExprKind::kMemberAccess)
             , object{ object }
             , member{ member }
@@ -272,7 +272,7 @@ namespace neo {
 
     public:
         ASTExpr* object;
-        std::string member;
+        NSymbol member;
         bool isUnsafeAccess = false;
     };
 
@@ -280,7 +280,7 @@ namespace neo {
     class VariableRefExpr : public ASTExpr
     {
     public:
-        VariableRefExpr(const std::string& name)
+        VariableRefExpr(NSymbol name)
             : ASTExpr(ExprKind::kVar)
             , variableName{ name }
         {
@@ -290,7 +290,7 @@ namespace neo {
     public:
 
     public:
-        std::string variableName;
+        NSymbol variableName;
         bool moveVariable = false;
     };
 
@@ -316,7 +316,7 @@ namespace neo {
     class NewExpr : public ASTExpr 
     {
     public:
-        NewExpr(ASTTypeNode* type, std::vector<ASTExpr*> args)
+        NewExpr(ASTTypeNode* type, ASTList<ASTExpr*> args)
             : ASTExpr(ExprKind::kNew)
             , type {type}
             , arguments {args} 
@@ -331,7 +331,7 @@ namespace neo {
     public:
     public:
         ASTTypeNode* type;
-        std::vector<ASTExpr*> arguments;
-        bool isStackAlloc;
+        ASTList<ASTExpr*> arguments;
+        bool isStackAlloc = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,535 @@
+#include "FlatAST.hpp"
+
+#include "Decl.hpp"
+#include "Exprs.hpp"
+#include "Stmts.hpp"
+#include "Type.hpp"
+#include "neo/compiler/SourceFile.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace neo {
+
+    static_assert([]<typename... P>(std::tuple<std::vector<P>...>*) {
+        return ((std::is_trivially_copyable_v<P> && std::has_unique_object_representations_v<P>) && ...);
+    }((NFlatAST::Pools*)nullptr), "flat pools must stay memcpy-able and free of padding");
+
+
+    /// ASTNode graph -> pools, children are emitted before their parent
+    class FlatEncoder
+    {
+    public:
+        FlatEncoder(NFlatAST& out, NSourceFile* file)
+            : m_out {out}
+            , m_file {file}
+        {}
+
+        FlatRef node(ASTNode* n) {
+            if (n == nullptr) {
+                return {};
+            }
+            switch (n->getType()) {
+            case kStatment:
+                return stmt((ASTStmt*)n);
+            case kDeclaration:
+                return decl((ASTDecl*)n);
+            case kType:
+            case kTypeArray:
+            case kTypePointer:
+                return type((ASTTypeNode*)n);
+            default:
+                NE_ASSERT(false && "unknown ast node");
+                return {};
+            }
+        }
+
+        template <typename T>
+        FlatRange list(const ASTList<T*>& items) {
+            // encode first, nested lists append to refs while we are still walking this one
+            std::vector<FlatRef> tmp {};
+            tmp.reserve(items.size());
+            for (auto* item : items) {
+                tmp.push_back(node(item));
+            }
+            FlatRange range {(u32)m_out.refs.size(), (u32)tmp.size()};
+            m_out.refs.insert(m_out.refs.end(), tmp.begin(), tmp.end());
+            return range;
+        }
+
+    private:
+        /// process wide symbol -> index into m_out.symbols
+        NSymbol sym(NSymbol global) {
+            if (global.empty()) {
+                return {};
+            }
+            auto [it, added] = m_symbols.try_emplace(global.id, (u32)m_out.symbols.size());
+            if (added) {
+                m_out.symbols.push_back(global);
+            }
+            return NSymbol {it->second};
+        }
+
+        template <typename T>
+        FlatRef push(const T& flat) {
+            auto& pool = m_out.pool<T>();
+            NE_ASSERT(pool.size() < FlatRef::kMaxIndex);
+            pool.push_back(flat);
+            return FlatRef::make(T::kKind, (u32)pool.size() - 1);
+        }
+
+        u32 loc(ASTNode* n) {
+            if (n->m_loc.file == nullptr) {
+                return kNoOffset;
+            }
+            NE_ASSERT(n->m_loc.file == m_file);
+            return m_file->offsetOf(n->m_loc);
+        }
+
+        FlatDeclHead head(ASTDecl* d) {
+            std::vector<FlatRef> tmp {};
+            tmp.reserve(d->attributes.size());
+            for (auto* attribute : d->attributes) {
+                tmp.push_back(push(FlatAttribute {sym(attribute->name), list(attribute->arguments)}));
+            }
+            FlatRange attrs {(u32)m_out.refs.size(), (u32)tmp.size()};
+            m_out.refs.insert(m_out.refs.end(), tmp.begin(), tmp.end());
+            return FlatDeclHead {loc(d), attrs, d->modifier.pack(), d->isMarkedExport};
+        }
+
+        FlatRef type(ASTTypeNode* t) {
+            switch (t->getType()) {
+            case kTypeArray: {
+                auto* a = (ASTArrayType*)t;
+                FlatRange size {(u32)m_out.ints.size(), (u32)a->size.size()};
+                m_out.ints.insert(m_out.ints.end(), a->size.begin(), a->size.end());
+                return push(FlatArrayType {loc(t), sym(a->typeStr), a->dimenssion, size, a->isReceiver});
+            }
+            case kTypePointer:
+                return push(FlatPointerType {loc(t), sym(t->typeStr)});
+            default:
+                return push(FlatTypeNode {loc(t), sym(t->typeStr)});
+            }
+        }
+
+        FlatRef decl(ASTDecl* d) {
+            switch (d->getDeclKind()) {
+            case DeclKind::kVar: {
+                auto* n = (VarDecl*)d;
+                return push(FlatVarDecl {head(d), sym(n->name), node(n->type), node(n->initExpr)});
+            }
+            case DeclKind::kFunc: {
+                auto* n = (FuncDecl*)d;
+                return push(FlatFuncDecl {head(d), sym(n->name), list(n->args), node(n->returnType), node(n->funcBody)});
+            }
+            case DeclKind::kField: {
+                auto* n = (FieldDecl*)d;
+                return push(FlatFieldDecl {head(d), sym(n->name), sym(n->setFuncName), sym(n->getFuncName), node(n->type), node(n->init)});
+            }
+            case DeclKind::kClass: {
+                auto* n = (ClassDecl*)d;
+                return push(FlatClassDecl {head(d), sym(n->name), list(n->baseClasses), list(n->subDataTypes),
+                                           list(n->fields), list(n->variables), list(n->functions),
+                                           list(n->ctors), node(n->dtors)});
+            }
+            case DeclKind::kStruct: {
+                auto* n = (StructDecl*)d;
+                return push(FlatStructDecl {head(d), sym(n->name), list(n->variables), list(n->fields)});
+            }
+            case DeclKind::kInterface: {
+                auto* n = (InterfaceDecl*)d;
+                return push(FlatInterfaceDecl {head(d), sym(n->name), list(n->children)});
+            }
+            case DeclKind::kEnum: {
+                auto* n = (EnumDecl*)d;
+                return push(FlatEnumDecl {head(d), sym(n->name), list(n->children), node(n->baseType)});
+            }
+            case DeclKind::kModule: {
+                auto* n = (ModuleDecl*)d;
+                return push(FlatModuleDecl {head(d), sym(n->name), node(n->children)});
+            }
+            case DeclKind::kTopLevelDecls: {
+                auto* n = (TopLevelDecls*)d;
+                return push(FlatTopLevelDecls {head(d), list(n->decls)});
+            }
+            default:
+                NE_ASSERT(false && "unknown decl kind");
+                return {};
+            }
+        }
+
+        FlatRef stmt(ASTStmt* s) {
+            switch (s->getStmtKind()) {
+            case StmtKind::kExpression:
+                return expr((ASTExpr*)s);
+            case StmtKind::kCompound:
+                return push(FlatCompoundStmt {loc(s), list(((CompoundStmt*)s)->statements)});
+            case StmtKind::kIf: {
+                auto* n = (IfStmt*)s;
+                return push(FlatIfStmt {loc(s), node(n->ifExpr), node(n->defaultBranch), node(n->elseBranch)});
+            }
+            case StmtKind::kWhile: {
+                auto* n = (WhileStmt*)s;
+                return push(FlatWhileStmt {loc(s), node(n->condition), node(n->body)});
+            }
+            case StmtKind::kFor: {
+                auto* n = (ForStmt*)s;
+                return push(FlatForStmt {loc(s), node(n->declVar), node(n->cond), node(n->update), node(n->forBody)});
+            }
+            case StmtKind::kForeach: {
+                auto* n = (ForeachStmt*)s;
+                return push(FlatForeachStmt {loc(s), node(n->declearation), node(n->object)});
+            }
+            case StmtKind::kReturn:
+                return push(FlatReturnStmt {loc(s), node(((ReturnStmt*)s)->ret)});
+            case StmtKind::kBreak:
+                return push(FlatBreakStmt {loc(s)});
+            case StmtKind::kContinue:
+                return push(FlatContinueStmt {loc(s)});
+            case StmtKind::kImport:
+                return push(FlatImportStmt {loc(s), sym(((ImportStmt*)s)->moduleName)});
+            case StmtKind::kDecl:
+                return push(FlatDeclStmt {loc(s), node(((DeclStmt*)s)->declType)});
+            default:
+                NE_ASSERT(false && "unknown stmt kind");
+                return {};
+            }
+        }
+
+        FlatRef expr(ASTExpr* e) {
+            switch (e->getExprKind()) {
+            case ExprKind::kNumberLit: {
+                auto* n = (NumberLiteralExpr*)e;
+                FlatNumberLiteral flat {loc(e), (u32)n->m_type, 0};
+                std::memcpy(&flat.bits, &n->m_value, sizeof(n->m_value));
+                return push(flat);
+            }
+            case ExprKind::kBoolLit:
+                return push(FlatBoolLiteral {loc(e), ((BoolLiteralExpr*)e)->getValue()});
+            case ExprKind::kBinary: {
+                auto* n = (BinaryExpr*)e;
+                return push(FlatBinaryExpr {loc(e), (u32)n->op, node(n->left), node(n->right)});
+            }
+            case ExprKind::kUnary: {
+                auto* n = (UnaryExpr*)e;
+                return push(FlatUnaryExpr {loc(e), (u32)n->op, node(n->operand)});
+            }
+            case ExprKind::kFuncCall: {
+                auto* n = (CallExpr*)e;
+                return push(FlatCallExpr {loc(e), node(n->funcTag), list(n->callArgs)});
+            }
+            case ExprKind::kMemberAccess: {
+                auto* n = (MemberAccessExpr*)e;
+                return push(FlatMemberAccessExpr {loc(e), node(n->object), sym(n->member), n->isUnsafeAccess});
+            }
+            case ExprKind::kVar: {
+                auto* n = (VariableRefExpr*)e;
+                return push(FlatVariableRefExpr {loc(e), sym(n->variableName), n->moveVariable});
+            }
+            case ExprKind::kCast: {
+                auto* n = (CastExpr*)e;
+                return push(FlatCastExpr {loc(e), node(n->castTo), node(n->object)});
+            }
+            case ExprKind::kNew: {
+                auto* n = (NewExpr*)e;
+                return push(FlatNewExpr {loc(e), node(n->type), list(n->arguments), n->isStackAlloc});
+            }
+            default:
+                NE_ASSERT(false && "unknown expr kind");
+                return {};
+            }
+        }
+
+    private:
+        NFlatAST& m_out;
+        NSourceFile* m_file;
+        std::unordered_map<u32, u32> m_symbols;
+    };
+
+
+    /// pools -> ASTNode graph inside an arena
+    class FlatDecoder
+    {
+    public:
+        FlatDecoder(const NFlatView& in, NArena& arena, NSourceFile* file)
+            : m_in {in}
+            , m_arena {arena}
+            , m_file {file}
+        {}
+
+        ASTNode* node(FlatRef ref) {
+            switch (ref.kind()) {
+            case FlatKind::kNone:
+                return nullptr;
+
+            case FlatKind::kType: {
+                auto& f = m_in.get<FlatTypeNode>(ref);
+                return located(make<ASTTypeNode>(sym(f.typeStr)), f.loc);
+            }
+            case FlatKind::kArrayType: {
+                auto& f = m_in.get<FlatArrayType>(ref);
+                auto* n = make<ASTArrayType>(sym(f.typeStr), f.isReceiver, std::initializer_list<int> {});
+                n->size.assign(m_in.ints.begin() + f.size.begin, m_in.ints.begin() + f.size.begin + f.size.count);
+                n->dimenssion = f.dimenssion;
+                return located(n, f.loc);
+            }
+            case FlatKind::kPointerType: {
+                auto& f = m_in.get<FlatPointerType>(ref);
+                return located(make<ASTPointerType>(sym(f.typeStr)), f.loc);
+            }
+
+            case FlatKind::kVarDecl: {
+                auto& f = m_in.get<FlatVarDecl>(ref);
+                return head(make<VarDecl>(sym(f.name), as<ASTTypeNode>(f.type), as<ASTExpr>(f.initExpr)), f.head);
+            }
+            case FlatKind::kFuncDecl: {
+                auto& f = m_in.get<FlatFuncDecl>(ref);
+                return head(make<FuncDecl>(sym(f.name), as<ASTTypeNode>(f.returnType), list<VarDecl>(f.args), as<CompoundStmt>(f.funcBody)), f.head);
+            }
+            case FlatKind::kFieldDecl: {
+                auto& f = m_in.get<FlatFieldDecl>(ref);
+                auto* n = make<FieldDecl>(sym(f.name), as<ASTTypeNode>(f.type), as<ASTExpr>(f.init));
+                n->setFuncName = sym(f.setFuncName);
+                n->getFuncName = sym(f.getFuncName);
+                return head(n, f.head);
+            }
+            case FlatKind::kClassDecl: {
+                auto& f = m_in.get<FlatClassDecl>(ref);
+                auto* n = make<ClassDecl>(sym(f.name), list<ASTTypeNode>(f.baseClasses));
+                n->subDataTypes = list<ASTDecl>(f.subDataTypes);
+                n->fields = list<FieldDecl>(f.fields);
+                n->variables = list<VarDecl>(f.variables);
+                n->functions = list<FuncDecl>(f.functions);
+                n->ctors = list<FuncDecl>(f.ctors);
+                n->dtors = as<FuncDecl>(f.dtors);
+                return head(n, f.head);
+            }
+            case FlatKind::kStructDecl: {
+                auto& f = m_in.get<FlatStructDecl>(ref);
+                auto* n = make<StructDecl>(sym(f.name));
+                n->variables = list<VarDecl>(f.variables);
+                n->fields = list<FieldDecl>(f.fields);
+                return head(n, f.head);
+            }
+            case FlatKind::kInterfaceDecl: {
+                auto& f = m_in.get<FlatInterfaceDecl>(ref);
+                auto* n = make<InterfaceDecl>(sym(f.name));
+                n->children = list<FuncDecl>(f.children);
+                return head(n, f.head);
+            }
+            case FlatKind::kEnumDecl: {
+                auto& f = m_in.get<FlatEnumDecl>(ref);
+                auto* n = make<EnumDecl>(sym(f.name));
+                n->children = list<VarDecl>(f.children);
+                n->baseType = as<ASTTypeNode>(f.baseType);
+                return head(n, f.head);
+            }
+            case FlatKind::kModuleDecl: {
+                auto& f = m_in.get<FlatModuleDecl>(ref);
+                auto* n = make<ModuleDecl>(sym(f.name));
+                n->children = as<TopLevelDecls>(f.children);
+                return head(n, f.head);
+            }
+            case FlatKind::kTopLevelDecls: {
+                auto& f = m_in.get<FlatTopLevelDecls>(ref);
+                auto* n = make<TopLevelDecls>();
+                n->decls = list<ASTDecl>(f.decls);
+                return head(n, f.head);
+            }
+
+            case FlatKind::kCompound: {
+                auto& f = m_in.get<FlatCompoundStmt>(ref);
+                return located(make<CompoundStmt>(list<ASTStmt>(f.statements)), f.loc);
+            }
+            case FlatKind::kIf: {
+                auto& f = m_in.get<FlatIfStmt>(ref);
+                return located(make<IfStmt>(as<ASTExpr>(f.ifExpr), as<ASTStmt>(f.defaultBranch), as<ASTStmt>(f.elseBranch)), f.loc);
+            }
+            case FlatKind::kWhile: {
+                auto& f = m_in.get<FlatWhileStmt>(ref);
+                return located(make<WhileStmt>(as<ASTExpr>(f.condition), as<ASTStmt>(f.body)), f.loc);
+            }
+            case FlatKind::kFor: {
+                auto& f = m_in.get<FlatForStmt>(ref);
+                return located(make<ForStmt>(as<ASTStmt>(f.declVar), as<ASTExpr>(f.cond), as<ASTExpr>(f.update), as<ASTStmt>(f.forBody)), f.loc);
+            }
+            case FlatKind::kForeach: {
+                auto& f = m_in.get<FlatForeachStmt>(ref);
+                return located(make<ForeachStmt>(as<ASTStmt>(f.declearation), as<ASTExpr>(f.object)), f.loc);
+            }
+            case FlatKind::kReturn: {
+                auto& f = m_in.get<FlatReturnStmt>(ref);
+                return located(make<ReturnStmt>(as<ASTExpr>(f.ret)), f.loc);
+            }
+            case FlatKind::kBreak:
+                return located(make<BreakStmt>(), m_in.get<FlatBreakStmt>(ref).loc);
+            case FlatKind::kContinue:
+                return located(make<ContinueStmt>(), m_in.get<FlatContinueStmt>(ref).loc);
+            case FlatKind::kImport: {
+                auto& f = m_in.get<FlatImportStmt>(ref);
+                return located(make<ImportStmt>(sym(f.moduleName)), f.loc);
+            }
+            case FlatKind::kDeclStmt: {
+                auto& f = m_in.get<FlatDeclStmt>(ref);
+                return located(make<DeclStmt>(as<ASTDecl>(f.declType)), f.loc);
+            }
+
+            case FlatKind::kNumberLit: {
+                auto& f = m_in.get<FlatNumberLiteral>(ref);
+                auto* n = make<NumberLiteralExpr>((i32)0);
+                std::memcpy(&n->m_value, &f.bits, sizeof(n->m_value));
+                n->m_type = (LiteralType)f.type;
+                return located(n, f.loc);
+            }
+            case FlatKind::kBoolLit: {
+                auto& f = m_in.get<FlatBoolLiteral>(ref);
+                return located(make<BoolLiteralExpr>(f.value), f.loc);
+            }
+            case FlatKind::kBinary: {
+                auto& f = m_in.get<FlatBinaryExpr>(ref);
+                return located(make<BinaryExpr>((BinaryOp)f.op, as<ASTExpr>(f.left), as<ASTExpr>(f.right)), f.loc);
+            }
+            case FlatKind::kUnary: {
+                auto& f = m_in.get<FlatUnaryExpr>(ref);
+                return located(make<UnaryExpr>((UnaryOp)f.op, as<ASTExpr>(f.operand)), f.loc);
+            }
+            case FlatKind::kCall: {
+                auto& f = m_in.get<FlatCallExpr>(ref);
+                return located(make<CallExpr>(as<ASTExpr>(f.funcTag), list<ASTExpr>(f.callArgs)), f.loc);
+            }
+            case FlatKind::kMemberAccess: {
+                auto& f = m_in.get<FlatMemberAccessExpr>(ref);
+                auto* n = make<MemberAccessExpr>(as<ASTExpr>(f.object), sym(f.member));
+                n->isUnsafeAccess = f.isUnsafeAccess;
+                return located(n, f.loc);
+            }
+            case FlatKind::kVarRef: {
+                auto& f = m_in.get<FlatVariableRefExpr>(ref);
+                auto* n = make<VariableRefExpr>(sym(f.variableName));
+                n->moveVariable = f.moveVariable;
+                return located(n, f.loc);
+            }
+            case FlatKind::kCast: {
+                auto& f = m_in.get<FlatCastExpr>(ref);
+                return located(make<CastExpr>(as<ASTExpr>(f.object), as<ASTTypeNode>(f.castTo)), f.loc);
+            }
+            case FlatKind::kNew: {
+                auto& f = m_in.get<FlatNewExpr>(ref);
+                auto* n = make<NewExpr>(as<ASTTypeNode>(f.type), list<ASTExpr>(f.arguments));
+                n->isStackAlloc = f.isStackAlloc;
+                return located(n, f.loc);
+            }
+
+            default:
+                NE_ASSERT(false && "bad flat node kind");
+                return nullptr;
+            }
+        }
+
+    private:
+        template <typename T, typename... Args>
+        T* make(Args&&... args) {
+            return m_arena.make<T>(std::forward<Args>(args)...);
+        }
+
+        NSymbol sym(NSymbol local) {
+            return m_in.symbol(local);
+        }
+
+        template <typename T>
+        T* as(FlatRef ref) {
+            return (T*)node(ref);
+        }
+
+        template <typename T>
+        ASTList<T*> list(FlatRange range) {
+            ASTList<T*> items {NArenaAllocator<T*> {&m_arena}};
+            items.reserve(range.count);
+            for (FlatRef ref : m_in.children(range)) {
+                items.push_back(as<T>(ref));
+            }
+            return items;
+        }
+
+        template <typename T>
+        T* located(T* n, u32 offset) {
+            if (offset != kNoOffset) {
+                n->m_loc = m_file->locate(offset);
+            }
+            return n;
+        }
+
+        template <typename T>
+        T* head(T* n, const FlatDeclHead& h) {
+            n->modifier = ASTModifier::unpack(h.modifier);
+            n->isMarkedExport = h.isMarkedExport;
+            n->attributes = AttributeList {NArenaAllocator<Attribute*> {&m_arena}};
+            n->attributes.reserve(h.attributes.count);
+            for (FlatRef ref : m_in.children(h.attributes)) {
+                auto& f = m_in.get<FlatAttribute>(ref);
+                auto* attribute = make<Attribute>();
+                attribute->name = sym(f.name);
+                attribute->arguments = list<ASTExpr>(f.arguments);
+                n->attributes.push_back(attribute);
+            }
+            return located(n, h.loc);
+        }
+
+    private:
+        const NFlatView& m_in;
+        NArena& m_arena;
+        NSourceFile* m_file;
+    };
+
+
+    NFlatAST NFlatAST::fromNodes(const std::vector<ASTNode*>& nodes, NSourceFile* file)
+    {
+        NFlatAST out {};
+        out.symbols.push_back(NSymbol {});
+        FlatEncoder encoder {out, file};
+
+        std::vector<FlatRef> roots {};
+        roots.reserve(nodes.size());
+        for (auto* n : nodes) {
+            roots.push_back(encoder.node(n));
+        }
+        out.roots = {(u32)out.refs.size(), (u32)roots.size()};
+        out.refs.insert(out.refs.end(), roots.begin(), roots.end());
+        return out;
+    }
+
+
+    NFlatView NFlatAST::view() const
+    {
+        NFlatView v {};
+        std::apply([&](auto&... spans) {
+            ((spans = pool<typename std::decay_t<decltype(spans)>::value_type>()), ...);
+        }, v.pools);
+        v.refs = refs;
+        v.ints = ints;
+        v.symbols = symbols;
+        v.roots = roots;
+        return v;
+    }
+
+
+    void NFlatView::toNodes(NArena& arena, std::vector<ASTNode*>& out, NSourceFile* file) const
+    {
+        // lists default constructed inside the nodes bind to the current arena
+        NArena::Scope arenaScope {arena};
+        FlatDecoder decoder {*this, arena, file};
+
+        out.reserve(out.size() + roots.count);
+        for (FlatRef ref : children(roots)) {
+            out.push_back(decoder.node(ref));
+        }
+    }
+
+
+    psize NFlatAST::nodeCount() const
+    {
+        psize count = 0;
+        std::apply([&](const auto&... pools) { ((count += pools.size()), ...); }, m_pools);
+        return count;
+    }
+}
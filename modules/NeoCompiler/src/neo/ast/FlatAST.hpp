@@ -0,0 +1,241 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "neo/base/Assert.hpp"
+
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace neo {
+
+    class NSourceFile;
+
+    /// Pool a flat node lives in, one per concrete AST class
+    enum class FlatKind : u8 {
+        kNone,
+        kType, kArrayType, kPointerType,
+        kVarDecl, kFuncDecl, kFieldDecl, kClassDecl, kStructDecl,
+        kInterfaceDecl, kEnumDecl, kModuleDecl, kTopLevelDecls,
+        kCompound, kIf, kWhile, kFor, kForeach, kReturn,
+        kBreak, kContinue, kImport, kDeclStmt,
+        kNumberLit, kBoolLit, kBinary, kUnary, kCall,
+        kMemberAccess, kVarRef, kCast, kNew,
+        kAttribute,
+        kCount
+    };
+
+
+    /// Reference to a flat node, the pool kind sits in the top 6 bits and the pool index below.
+    /// The all zero value is the null reference.
+    struct FlatRef
+    {
+        static constexpr u32 kIndexBits = 26;
+        static constexpr u32 kMaxIndex = (1u << kIndexBits) - 1;
+
+        u32 raw = 0;
+
+        static FlatRef make(FlatKind kind, u32 index) {
+            return FlatRef { ((u32)kind << kIndexBits) | index };
+        }
+
+        FlatKind kind() const {
+            return (FlatKind)(raw >> kIndexBits);
+        }
+        u32 index() const {
+            return raw & kMaxIndex;
+        }
+        bool isNull() const {
+            return raw == 0;
+        }
+    };
+    static_assert((u32)FlatKind::kCount <= (1u << (32 - FlatRef::kIndexBits)));
+
+
+    /// Child list, a slice of NFlatAST::refs (or NFlatAST::ints for array sizes)
+    struct FlatRange
+    {
+        u32 begin = 0;
+        u32 count = 0;
+    };
+
+
+    /// Source location as a byte offset into the file, kNoOffset when the node has none
+    static constexpr u32 kNoOffset = ~0u;
+
+
+    // Pool structs are laid out without implicit padding (checked in FlatAST.cpp),
+    // so equal trees always produce equal bytes. Short fields go last with explicit pad bytes.
+
+    struct FlatDeclHead
+    {
+        u32 loc;
+        FlatRange attributes;   // FlatKind::kAttribute refs
+        u8 modifier;            // ASTModifier::pack
+        bool isMarkedExport;
+        u8 pad[2] {};
+    };
+
+    struct FlatAttribute { static constexpr auto kKind = FlatKind::kAttribute; NSymbol name; FlatRange arguments; };
+
+    struct FlatTypeNode { static constexpr auto kKind = FlatKind::kType; u32 loc; NSymbol typeStr; };
+    struct FlatArrayType { static constexpr auto kKind = FlatKind::kArrayType; u32 loc; NSymbol typeStr; i32 dimenssion; FlatRange size; bool isReceiver; u8 pad[3] {}; };
+    struct FlatPointerType { static constexpr auto kKind = FlatKind::kPointerType; u32 loc; NSymbol typeStr; };
+
+    struct FlatVarDecl { static constexpr auto kKind = FlatKind::kVarDecl; FlatDeclHead head; NSymbol name; FlatRef type; FlatRef initExpr; };
+    struct FlatFuncDecl { static constexpr auto kKind = FlatKind::kFuncDecl; FlatDeclHead head; NSymbol name; FlatRange args; FlatRef returnType; FlatRef funcBody; };
+    struct FlatFieldDecl { static constexpr auto kKind = FlatKind::kFieldDecl; FlatDeclHead head; NSymbol name; NSymbol setFuncName; NSymbol getFuncName; FlatRef type; FlatRef init; };
+    struct FlatClassDecl {
+        static constexpr auto kKind = FlatKind::kClassDecl;
+        FlatDeclHead head;
+        NSymbol name;
+        FlatRange baseClasses;
+        FlatRange subDataTypes;
+        FlatRange fields;
+        FlatRange variables;
+        FlatRange functions;
+        FlatRange ctors;
+        FlatRef dtors;
+    };
+    struct FlatStructDecl { static constexpr auto kKind = FlatKind::kStructDecl; FlatDeclHead head; NSymbol name; FlatRange variables; FlatRange fields; };
+    struct FlatInterfaceDecl { static constexpr auto kKind = FlatKind::kInterfaceDecl; FlatDeclHead head; NSymbol name; FlatRange children; };
+    struct FlatEnumDecl { static constexpr auto kKind = FlatKind::kEnumDecl; FlatDeclHead head; NSymbol name; FlatRange children; FlatRef baseType; };
+    struct FlatModuleDecl { static constexpr auto kKind = FlatKind::kModuleDecl; FlatDeclHead head; NSymbol name; FlatRef children; };
+    struct FlatTopLevelDecls { static constexpr auto kKind = FlatKind::kTopLevelDecls; FlatDeclHead head; FlatRange decls; };
+
+    struct FlatCompoundStmt { static constexpr auto kKind = FlatKind::kCompound; u32 loc; FlatRange statements; };
+    struct FlatIfStmt { static constexpr auto kKind = FlatKind::kIf; u32 loc; FlatRef ifExpr; FlatRef defaultBranch; FlatRef elseBranch; };
+    struct FlatWhileStmt { static constexpr auto kKind = FlatKind::kWhile; u32 loc; FlatRef condition; FlatRef body; };
+    struct FlatForStmt { static constexpr auto kKind = FlatKind::kFor; u32 loc; FlatRef declVar; FlatRef cond; FlatRef update; FlatRef forBody; };
+    struct FlatForeachStmt { static constexpr auto kKind = FlatKind::kForeach; u32 loc; FlatRef declearation; FlatRef object; };
+    struct FlatReturnStmt { static constexpr auto kKind = FlatKind::kReturn; u32 loc; FlatRef ret; };
+    struct FlatBreakStmt { static constexpr auto kKind = FlatKind::kBreak; u32 loc; };
+    struct FlatContinueStmt { static constexpr auto kKind = FlatKind::kContinue; u32 loc; };
+    struct FlatImportStmt { static constexpr auto kKind = FlatKind::kImport; u32 loc; NSymbol moduleName; };
+    struct FlatDeclStmt { static constexpr auto kKind = FlatKind::kDeclStmt; u32 loc; FlatRef declType; };
+
+    struct FlatNumberLiteral { static constexpr auto kKind = FlatKind::kNumberLit; u32 loc; u32 type; u64 bits; };
+    struct FlatBoolLiteral { static constexpr auto kKind = FlatKind::kBoolLit; u32 loc; bool value; u8 pad[3] {}; };
+    struct FlatBinaryExpr { static constexpr auto kKind = FlatKind::kBinary; u32 loc; u32 op; FlatRef left; FlatRef right; };
+    struct FlatUnaryExpr { static constexpr auto kKind = FlatKind::kUnary; u32 loc; u32 op; FlatRef operand; };
+    struct FlatCallExpr { static constexpr auto kKind = FlatKind::kCall; u32 loc; FlatRef funcTag; FlatRange callArgs; };
+    struct FlatMemberAccessExpr { static constexpr auto kKind = FlatKind::kMemberAccess; u32 loc; FlatRef object; NSymbol member; bool isUnsafeAccess; u8 pad[3] {}; };
+    struct FlatVariableRefExpr { static constexpr auto kKind = FlatKind::kVarRef; u32 loc; NSymbol variableName; bool moveVariable; u8 pad[3] {}; };
+    struct FlatCastExpr { static constexpr auto kKind = FlatKind::kCast; u32 loc; FlatRef castTo; FlatRef object; };
+    struct FlatNewExpr { static constexpr auto kKind = FlatKind::kNew; u32 loc; FlatRef type; FlatRange arguments; bool isStackAlloc; u8 pad[3] {}; };
+
+
+    /// every pool element type, in on-disk order
+    using FlatPoolTypes = std::tuple<
+        FlatAttribute,
+        FlatTypeNode, FlatArrayType, FlatPointerType,
+        FlatVarDecl, FlatFuncDecl, FlatFieldDecl, FlatClassDecl, FlatStructDecl,
+        FlatInterfaceDecl, FlatEnumDecl, FlatModuleDecl, FlatTopLevelDecls,
+        FlatCompoundStmt, FlatIfStmt, FlatWhileStmt, FlatForStmt, FlatForeachStmt, FlatReturnStmt,
+        FlatBreakStmt, FlatContinueStmt, FlatImportStmt, FlatDeclStmt,
+        FlatNumberLiteral, FlatBoolLiteral, FlatBinaryExpr, FlatUnaryExpr, FlatCallExpr,
+        FlatMemberAccessExpr, FlatVariableRefExpr, FlatCastExpr, FlatNewExpr>;
+
+    template <template <typename> class Array, typename Types>
+    struct FlatPoolsOf;
+    template <template <typename> class Array, typename... T>
+    struct FlatPoolsOf<Array, std::tuple<T...>> {
+        using type = std::tuple<Array<T>...>;
+    };
+
+    template <typename T>
+    using FlatVector = std::vector<T>;
+    template <typename T>
+    using FlatSpan = std::span<const T>;
+
+
+    /// Read-only view over flat pools, backed by an NFlatAST or by a loaded .nast image.
+    /// Symbol fields in the pools are indices into symbols.
+    class NFlatView final
+    {
+    public:
+        using Pools = FlatPoolsOf<FlatSpan, FlatPoolTypes>::type;
+
+        /// rebuild the class based nodes inside arena, appended to out in the original order
+        void toNodes(NArena& arena, std::vector<ASTNode*>& out, NSourceFile* file) const;
+
+        template <typename T>
+        FlatSpan<T>& pool() {
+            return std::get<FlatSpan<T>>(pools);
+        }
+        template <typename T>
+        const FlatSpan<T>& pool() const {
+            return std::get<FlatSpan<T>>(pools);
+        }
+
+        template <typename T>
+        const T& get(FlatRef ref) const {
+            NE_ASSERT(ref.kind() == T::kKind);
+            return pool<T>()[ref.index()];
+        }
+        std::span<const FlatRef> children(FlatRange range) const {
+            return refs.subspan(range.begin, range.count);
+        }
+        NSymbol symbol(NSymbol local) const {
+            return symbols[local.id];
+        }
+
+    public:
+        Pools pools;
+        std::span<const FlatRef> refs;
+        std::span<const i32> ints;
+        std::span<const NSymbol> symbols;
+        FlatRange roots;
+    };
+
+
+    /// Flat encoding of a parsed file
+    /// nodes live in one contiguous pool per class and point at each other with FlatRef,
+    /// child lists are ranges into the shared refs array. Every array is trivially copyable,
+    /// so the whole tree can be written out with one memcpy per pool.
+    /// Symbols are numbered per tree (0 is the empty symbol), symbols maps them back.
+    class NFlatAST final
+    {
+    public:
+        using Pools = FlatPoolsOf<FlatVector, FlatPoolTypes>::type;
+
+        /// encode a node list, node locations are turned into offsets through file
+        static NFlatAST fromNodes(const std::vector<ASTNode*>& nodes, NSourceFile* file);
+        void toNodes(NArena& arena, std::vector<ASTNode*>& out, NSourceFile* file) const {
+            view().toNodes(arena, out, file);
+        }
+
+        NFlatView view() const;
+
+        template <typename T>
+        std::vector<T>& pool() {
+            return std::get<std::vector<T>>(m_pools);
+        }
+        template <typename T>
+        const std::vector<T>& pool() const {
+            return std::get<std::vector<T>>(m_pools);
+        }
+
+        /// calls fn(std::vector<X>&) for every pool, then refs and ints
+        template <typename Fn>
+        void forEachArray(Fn&& fn) {
+            std::apply([&](auto&... pools) { (fn(pools), ...); }, m_pools);
+            fn(refs);
+            fn(ints);
+        }
+
+        /// number of nodes over every pool
+        psize nodeCount() const;
+
+    public:
+        FlatRange roots;
+        std::vector<FlatRef> refs;
+        std::vector<i32> ints;
+        std::vector<NSymbol> symbols;
+
+    private:
+        Pools m_pools;
+    };
+}
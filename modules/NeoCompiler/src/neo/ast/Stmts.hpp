@@ -10,7 +10,7 @@ namespace neo {
     class CompoundStmt : public ASTStmt
     {
     public:
-        CompoundStmt(std::vector<ASTStmt*> stmts)
+        CompoundStmt(ASTList<ASTStmt*> stmts)
             : ASTStmt(StmtKind::kCompound)
             , statements{std::move( stmts )}
         {
@@ -25,7 +25,7 @@ namespace neo {
     public:
 
     public:
-        std::vector<ASTStmt*> statements;
+        ASTList<ASTStmt*> statements;
     };
 
 
@@ -137,14 +137,14 @@ namespace neo {
     class ImportStmt : public ASTStmt 
     {
     public:
-        ImportStmt(std::string name)
+        ImportStmt(NSymbol name)
             : ASTStmt(StmtKind::kImport)
-            , moduleName {std::move(name)}
+            , moduleName {name}
         {}
         ~ImportStmt() override = default;
 
     public:
-        const std::string moduleName;
+        const NSymbol moduleName;
     };
 
 
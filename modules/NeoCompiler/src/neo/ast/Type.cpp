@@ -1,13 +1,19 @@
 #include "Type.hpp"
 
-#include <utility>
 #include "neo/compiler/DebugOutput.hpp"
 
 namespace neo {
 
-    ASTTypeNode::ASTTypeNode(std::string type)
+    ASTTypeNode::ASTTypeNode(NSymbol type)
         : ASTNode(kType)
-        , typeStr {std::move(type)}
+        , typeStr {type}
+    {
+
+    }
+
+    ASTTypeNode::ASTTypeNode(ASTType kind, NSymbol type)
+        : ASTNode(kind)
+        , typeStr {type}
     {
 
     }
@@ -22,8 +28,8 @@ namespace neo {
     }
 
 
-    ASTArrayType::ASTArrayType(std::string typeStr, bool isReceiver, std::initializer_list<int> size)
-        : ASTTypeNode(std::move(typeStr))
+    ASTArrayType::ASTArrayType(NSymbol typeStr, bool isReceiver, std::initializer_list<int> size)
+        : ASTTypeNode(kTypeArray, typeStr)
         , isReceiver {isReceiver}
         , size {size}
     {
@@ -47,8 +53,8 @@ namespace neo {
     }
 
 
-    ASTPointerType::ASTPointerType(std::string typeStr)
-        : ASTTypeNode(std::move(typeStr))
+    ASTPointerType::ASTPointerType(NSymbol typeStr)
+        : ASTTypeNode(kTypePointer, typeStr)
     {
 
     }
@@ -8,21 +8,24 @@ namespace neo {
     class ASTTypeNode : public ASTNode
     {
     public:
-        ASTTypeNode(std::string type);
+        ASTTypeNode(NSymbol type);
         ~ASTTypeNode() override;
 
+    protected:
+        ASTTypeNode(ASTType kind, NSymbol type);
+
     public:
         void debugPrint(NDebugOutput& output) override;
 
     public:
-        std::string typeStr;
+        NSymbol typeStr;
     };
 
 
     class ASTArrayType : public ASTTypeNode
     {
     public:
-        ASTArrayType(std::string typeStr, bool isReceiver, std::initializer_list<int> size);
+        ASTArrayType(NSymbol typeStr, bool isReceiver, std::initializer_list<int> size);
         ~ASTArrayType() override;
 
     public:
@@ -30,15 +33,15 @@ namespace neo {
 
     public:
         bool isReceiver;
-        i32 dimenssion;
-        std::vector<i32> size;
+        i32 dimenssion = 0;
+        ASTList<i32> size;
     };
 
 
     class ASTPointerType : public ASTTypeNode
     {
     public:
-        ASTPointerType(std::string typeStr);
+        ASTPointerType(NSymbol typeStr);
         ~ASTPointerType() override;
     };
 }
\ No newline at end of file
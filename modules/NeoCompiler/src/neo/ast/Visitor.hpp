@@ -0,0 +1,256 @@
+#pragma once
+
+#include "Base.hpp"
+#include "Decl.hpp"
+#include "Exprs.hpp"
+#include "Stmts.hpp"
+#include "Type.hpp"
+
+#include "neo/base/Assert.hpp"
+
+namespace neo {
+
+    /// every concrete AST class, in kind tag order
+    #define NE_AST_NODE_CLASSES(X) \
+        X(ASTTypeNode) X(ASTArrayType) X(ASTPointerType) \
+        X(VarDecl) X(FuncDecl) X(ClassDecl) X(FieldDecl) X(StructDecl) \
+        X(ModuleDecl) X(InterfaceDecl) X(EnumDecl) X(TopLevelDecls) \
+        X(CompoundStmt) X(IfStmt) X(WhileStmt) X(ForStmt) X(ForeachStmt) \
+        X(ReturnStmt) X(BreakStmt) X(ContinueStmt) X(ImportStmt) X(DeclStmt) \
+        X(NumberLiteralExpr) X(BoolLiteralExpr) X(BinaryExpr) X(UnaryExpr) X(CallExpr) \
+        X(MemberAccessExpr) X(VariableRefExpr) X(CastExpr) X(NewExpr)
+
+
+    /// Call fn with n cast to its concrete class, picked by a switch over the kind tags.
+    /// Nodes with an unknown tag are passed as plain ASTNode*.
+    template <typename Fn>
+    NE_FORCE_INLINE decltype(auto) dispatchNode(ASTNode* n, Fn&& fn)
+    {
+        switch (n->getType()) {
+        case kType:         return fn((ASTTypeNode*)n);
+        case kTypeArray:    return fn((ASTArrayType*)n);
+        case kTypePointer:  return fn((ASTPointerType*)n);
+
+        case kDeclaration:
+            switch (((ASTDecl*)n)->getDeclKind()) {
+            case DeclKind::kVar:            return fn((VarDecl*)n);
+            case DeclKind::kFunc:           return fn((FuncDecl*)n);
+            case DeclKind::kClass:          return fn((ClassDecl*)n);
+            case DeclKind::kField:          return fn((FieldDecl*)n);
+            case DeclKind::kStruct:         return fn((StructDecl*)n);
+            case DeclKind::kModule:         return fn((ModuleDecl*)n);
+            case DeclKind::kInterface:      return fn((InterfaceDecl*)n);
+            case DeclKind::kEnum:           return fn((EnumDecl*)n);
+            case DeclKind::kTopLevelDecls:  return fn((TopLevelDecls*)n);
+            default: break;
+            }
+            break;
+
+        case kStatment:
+            switch (((ASTStmt*)n)->getStmtKind()) {
+            case StmtKind::kCompound:   return fn((CompoundStmt*)n);
+            case StmtKind::kIf:         return fn((IfStmt*)n);
+            case StmtKind::kWhile:      return fn((WhileStmt*)n);
+            case StmtKind::kFor:        return fn((ForStmt*)n);
+            case StmtKind::kForeach:    return fn((ForeachStmt*)n);
+            case StmtKind::kReturn:     return fn((ReturnStmt*)n);
+            case StmtKind::kBreak:      return fn((BreakStmt*)n);
+            case StmtKind::kContinue:   return fn((ContinueStmt*)n);
+            case StmtKind::kImport:     return fn((ImportStmt*)n);
+            case StmtKind::kDecl:       return fn((DeclStmt*)n);
+            case StmtKind::kExpression:
+                switch (((ASTExpr*)n)->getExprKind()) {
+                case ExprKind::kNumberLit:      return fn((NumberLiteralExpr*)n);
+                case ExprKind::kBoolLit:        return fn((BoolLiteralExpr*)n);
+                case ExprKind::kBinary:         return fn((BinaryExpr*)n);
+                case ExprKind::kUnary:          return fn((UnaryExpr*)n);
+                case ExprKind::kFuncCall:       return fn((CallExpr*)n);
+                case ExprKind::kMemberAccess:   return fn((MemberAccessExpr*)n);
+                case ExprKind::kVar:            return fn((VariableRefExpr*)n);
+                case ExprKind::kCast:           return fn((CastExpr*)n);
+                case ExprKind::kNew:            return fn((NewExpr*)n);
+                default: break;
+                }
+                break;
+            default: break;
+            }
+            break;
+
+        default:
+            break;
+        }
+        return fn(n);
+    }
+
+
+    enum class VisitAction {
+        kContinue,      // walk into the children
+        kSkipChildren,  // don't walk the children, the post-order hook still runs
+        kStop           // end the whole walk
+    };
+
+
+    /// CRTP AST walker, dispatch is a kind switch so every hook call is direct and can be inlined.
+    /// Derived overrides visitXxx (pre-order) and leaveXxx (post-order, false stops the walk)
+    /// for the classes it cares about, the rest fall back to visitNode / leaveNode.
+    ///
+    ///     struct FuncCounter : ASTVisitor<FuncCounter> {
+    ///         u32 count = 0;
+    ///         VisitAction visitFuncDecl(FuncDecl*) { count++; return VisitAction::kSkipChildren; }
+    ///     };
+    template <typename Derived>
+    class ASTVisitor
+    {
+    public:
+        /// walk n and everything below it, false when a hook stopped the walk
+        bool walk(ASTNode* n) {
+            if (n == nullptr) {
+                return true;
+            }
+            return dispatchNode(n, [this](auto* node) { return walkNode(node); });
+        }
+
+        template <typename T, typename Alloc>
+        bool walk(const std::vector<T*, Alloc>& nodes) {
+            for (auto* n : nodes) {
+                if (!walk(n)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+        VisitAction visitNode(ASTNode*) {
+            return VisitAction::kContinue;
+        }
+        bool leaveNode(ASTNode*) {
+            return true;
+        }
+
+        #define NE_VISITOR_HOOKS(CLASS) \
+            VisitAction visit##CLASS(CLASS* n) { return derived().visitNode(n); } \
+            bool leave##CLASS(CLASS* n) { return derived().leaveNode(n); }
+        NE_AST_NODE_CLASSES(NE_VISITOR_HOOKS)
+        #undef NE_VISITOR_HOOKS
+
+    private:
+        Derived& derived() {
+            return *static_cast<Derived*>(this);
+        }
+
+        template <typename T>
+        bool walkNode(T* n) {
+            VisitAction action = callVisit(n);
+            if (action == VisitAction::kStop) {
+                return false;
+            }
+            if (action == VisitAction::kContinue && !walkChildren(n)) {
+                return false;
+            }
+            return callLeave(n);
+        }
+
+        #define NE_VISITOR_CALLS(CLASS) \
+            VisitAction callVisit(CLASS* n) { return derived().visit##CLASS(n); } \
+            bool callLeave(CLASS* n) { return derived().leave##CLASS(n); }
+        NE_AST_NODE_CLASSES(NE_VISITOR_CALLS)
+        #undef NE_VISITOR_CALLS
+
+        VisitAction callVisit(ASTNode* n) {
+            return derived().visitNode(n);
+        }
+        bool callLeave(ASTNode* n) {
+            return derived().leaveNode(n);
+        }
+
+        bool walkAttributes(ASTDecl* n) {
+            for (auto* attribute : n->attributes) {
+                if (!walk(attribute->arguments)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // children in source order
+        bool walkChildren(ASTNode*) { return true; }
+        bool walkChildren(ASTTypeNode*) { return true; }
+
+        bool walkChildren(VarDecl* n) {
+            return walkAttributes(n) && walk(n->type) && walk(n->initExpr);
+        }
+        bool walkChildren(FuncDecl* n) {
+            return walkAttributes(n) && walk(n->args) && walk(n->returnType) && walk(n->funcBody);
+        }
+        bool walkChildren(ClassDecl* n) {
+            return walkAttributes(n) && walk(n->baseClasses) && walk(n->subDataTypes) && walk(n->fields)
+                && walk(n->variables) && walk(n->functions) && walk(n->ctors) && walk(n->dtors);
+        }
+        bool walkChildren(FieldDecl* n) {
+            return walkAttributes(n) && walk(n->type) && walk(n->init);
+        }
+        bool walkChildren(StructDecl* n) {
+            return walkAttributes(n) && walk(n->variables) && walk(n->fields);
+        }
+        bool walkChildren(ModuleDecl* n) {
+            return walkAttributes(n) && walk(n->children);
+        }
+        bool walkChildren(InterfaceDecl* n) {
+            return walkAttributes(n) && walk(n->children);
+        }
+        bool walkChildren(EnumDecl* n) {
+            return walkAttributes(n) && walk(n->baseType) && walk(n->children);
+        }
+        bool walkChildren(TopLevelDecls* n) {
+            return walkAttributes(n) && walk(n->decls);
+        }
+
+        bool walkChildren(CompoundStmt* n) {
+            return walk(n->statements);
+        }
+        bool walkChildren(IfStmt* n) {
+            return walk(n->ifExpr) && walk(n->defaultBranch) && walk(n->elseBranch);
+        }
+        bool walkChildren(WhileStmt* n) {
+            return walk(n->condition) && walk(n->body);
+        }
+        bool walkChildren(ForStmt* n) {
+            return walk(n->declVar) && walk(n->cond) && walk(n->update) && walk(n->forBody);
+        }
+        bool walkChildren(ForeachStmt* n) {
+            return walk(n->declearation) && walk(n->object);
+        }
+        bool walkChildren(ReturnStmt* n) {
+            return walk(n->ret);
+        }
+        bool walkChildren(BreakStmt*) { return true; }
+        bool walkChildren(ContinueStmt*) { return true; }
+        bool walkChildren(ImportStmt*) { return true; }
+        bool walkChildren(DeclStmt* n) {
+            return walk(n->declType);
+        }
+
+        bool walkChildren(NumberLiteralExpr*) { return true; }
+        bool walkChildren(BoolLiteralExpr*) { return true; }
+        bool walkChildren(BinaryExpr* n) {
+            return walk(n->left) && walk(n->right);
+        }
+        bool walkChildren(UnaryExpr* n) {
+            return walk(n->operand);
+        }
+        bool walkChildren(CallExpr* n) {
+            return walk(n->funcTag) && walk(n->callArgs);
+        }
+        bool walkChildren(MemberAccessExpr* n) {
+            return walk(n->object);
+        }
+        bool walkChildren(VariableRefExpr*) { return true; }
+        bool walkChildren(CastExpr* n) {
+            return walk(n->object) && walk(n->castTo);
+        }
+        bool walkChildren(NewExpr* n) {
+            return walk(n->type) && walk(n->arguments);
+        }
+    };
+}
@@ -0,0 +1,84 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace neo {
+
+    static thread_local NArena* t_current = nullptr;
+
+
+    NArena::~NArena()
+    {
+        reset();
+    }
+
+
+    void NArena::reset()
+    {
+        for (auto* entry = m_dtors; entry != nullptr; entry = entry->next) {
+            entry->destroy(entry + 1);
+        }
+        m_dtors = nullptr;
+
+        while (m_blocks != nullptr) {
+            Block* next = m_blocks->next;
+            NMemStats::onFree(m_tag, sizeof(Block) + m_blocks->size);
+            std::free(m_blocks);
+            m_blocks = next;
+        }
+        m_cur = nullptr;
+        m_end = nullptr;
+        m_used = 0;
+        m_reserved = 0;
+    }
+
+
+    void* NArena::allocateSlow(psize size, psize align)
+    {
+        // oversized requests get a block of their own, the current block stays open
+        psize payload = std::max(kBlockSize, size + align);
+        auto* block = (Block*)std::malloc(sizeof(Block) + payload);
+        if (block == nullptr) {
+            throw std::bad_alloc {};
+        }
+        block->size = payload;
+        m_reserved += payload;
+        NMemStats::onAlloc(m_tag, sizeof(Block) + payload);
+
+        char* begin = (char*)(block + 1);
+        auto p = ((psize)begin + align - 1) & ~(align - 1);
+        if (payload == kBlockSize || m_cur == nullptr) {
+            block->next = m_blocks;
+            m_blocks = block;
+            m_cur = (char*)(p + size);
+            m_end = begin + payload;
+        }
+        else {
+            // keep the open block at the head so the bump pointer stays valid
+            block->next = m_blocks->next;
+            m_blocks->next = block;
+        }
+        m_used += size;
+        return (void*)p;
+    }
+
+
+    NArena* NArena::current()
+    {
+        return t_current;
+    }
+
+
+    NArena::Scope::Scope(NArena& arena)
+        : m_prev {t_current}
+    {
+        t_current = &arena;
+    }
+
+
+    NArena::Scope::~Scope()
+    {
+        t_current = m_prev;
+    }
+}
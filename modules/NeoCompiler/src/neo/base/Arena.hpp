@@ -0,0 +1,146 @@
+#pragma once
+
+#include <neo/common.hpp>
+#include <neo/base/MemStats.hpp>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace neo {
+
+    /// Bump-pointer arena
+    /// memory is handed out from large blocks and only released as a whole by reset() or the destructor.
+    /// Objects made with make<T>() that need a destructor are recorded and destroyed in reverse order.
+    class NArena final
+    {
+    public:
+        static constexpr psize kBlockSize = 64 * 1024;
+
+        /// blocks are accounted under tag
+        explicit NArena(MemTag tag = MemTag::kAst) : m_tag {tag} {}
+        ~NArena();
+
+        NArena(const NArena&) = delete;
+        NArena& operator=(const NArena&) = delete;
+
+    public:
+        NE_FORCE_INLINE void* allocate(psize size, psize align = alignof(std::max_align_t)) {
+            auto p = ((psize)m_cur + align - 1) & ~(align - 1);
+            if (p + size > (psize)m_end || m_cur == nullptr) {
+                return allocateSlow(size, align);
+            }
+            m_cur = (char*)(p + size);
+            m_used += size;
+            return (void*)p;
+        }
+
+        template <typename T, typename... Args>
+        T* make(Args&&... args) {
+            if constexpr (std::is_trivially_destructible_v<T>) {
+                return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            }
+            else {
+                // the destructor record sits right in front of the object
+                static_assert(alignof(T) <= alignof(DtorEntry), "over-aligned arena object");
+                auto* entry = (DtorEntry*)allocate(sizeof(DtorEntry) + sizeof(T), alignof(DtorEntry));
+                T* obj = ::new (entry + 1) T(std::forward<Args>(args)...);
+                entry->next = m_dtors;
+                entry->destroy = [](void* p) { ((T*)p)->~T(); };
+                m_dtors = entry;
+                return obj;
+            }
+        }
+
+        /// destroy every object and release every block
+        void reset();
+
+        psize bytesUsed() const {
+            return m_used;
+        }
+        psize bytesReserved() const {
+            return m_reserved;
+        }
+
+        /// arena that default constructed NArenaAllocator binds to on this thread
+        static NArena* current();
+
+        /// makes an arena current for the calling thread until the scope ends
+        class Scope
+        {
+        public:
+            explicit Scope(NArena& arena);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            NArena* m_prev;
+        };
+
+    private:
+        struct Block {
+            Block* next;
+            psize size;
+        };
+        struct DtorEntry {
+            DtorEntry* next;
+            void (*destroy)(void*);
+        };
+
+        void* allocateSlow(psize size, psize align);
+
+    private:
+        char* m_cur = nullptr;
+        char* m_end = nullptr;
+        Block* m_blocks = nullptr;
+        DtorEntry* m_dtors = nullptr;
+        psize m_used = 0;
+        psize m_reserved = 0;
+        MemTag m_tag;
+    };
+
+
+    /// std allocator over NArena, deallocate is a no-op and the arena frees in bulk.
+    /// Without an arena (none current at construction) it falls back to the global heap.
+    template <typename T>
+    class NArenaAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        NArenaAllocator() noexcept : m_arena {NArena::current()} {}
+        explicit NArenaAllocator(NArena* arena) noexcept : m_arena {arena} {}
+        template <typename U>
+        NArenaAllocator(const NArenaAllocator<U>& other) noexcept : m_arena {other.arena()} {}
+
+        T* allocate(psize n) {
+            if (m_arena == nullptr) {
+                return std::allocator<T>{}.allocate(n);
+            }
+            return (T*)m_arena->allocate(n * sizeof(T), alignof(T));
+        }
+        void deallocate(T* p, psize n) noexcept {
+            if (m_arena == nullptr) {
+                std::allocator<T>{}.deallocate(p, n);
+            }
+        }
+
+        NArena* arena() const {
+            return m_arena;
+        }
+
+        template <typename U>
+        bool operator==(const NArenaAllocator<U>& other) const noexcept {
+            return m_arena == other.arena();
+        }
+
+    private:
+        NArena* m_arena;
+    };
+}
@@ -4,6 +4,7 @@
 #include "Assert.hpp"
 
 #include "neo/common.hpp"
+#include "neo/base/Logger.hpp"
 
 #if NE_WINDOWS
 #include <windows.h>
@@ -60,6 +61,8 @@ namespace neo {
 
     void assertIt(const char* msg, const char* func, int line, const char* file)
     {
+        // lines still queued for the async writer or captured for this file die with the trap otherwise
+        flushLogsForCrash();
 #if NE_WINDOWS
         char txt[512];
         memset(&txt[0], 0, sizeof(char) * 512);
@@ -80,6 +83,7 @@ namespace neo {
         getStackTrace([](const char* tr) {
             printf("|> %s\n", tr);
         });
+        fflush(stdout);
         TK_DEBUG_BREAK();
     }
 
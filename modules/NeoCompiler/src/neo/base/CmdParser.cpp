@@ -5,6 +5,8 @@
 
 #include "neo/base/StringUtils.hpp"
 
+#include <charconv>
+
 namespace neo {
 
     NCmdParser::NCmdParser(i32 argc, char** argv) {
@@ -19,14 +21,24 @@ namespace neo {
         if (m_flags.contains(flag)) {
             return;
         }
-        m_flags.insert({flag, CmdFlag { .bFlag = bPtr }});
+        CmdFlag f {.kind = FlagKind::kBool, .bFlag = bPtr};
+        m_flags.insert({flag, f});
     }
 
     void NCmdParser::regStr(const char *flag, std::string& sPtr) {
         if (m_flags.contains(flag)) {
             return;
         }
-        m_flags.insert({flag, CmdFlag {.sFlag = &sPtr}});
+        CmdFlag f {.kind = FlagKind::kStr, .sFlag = &sPtr};
+        m_flags.insert({flag, f});
+    }
+
+    void NCmdParser::regU32(const char *flag, u32& uPtr) {
+        if (m_flags.contains(flag)) {
+            return;
+        }
+        CmdFlag f {.kind = FlagKind::kU32, .uFlag = &uPtr};
+        m_flags.insert({flag, f});
     }
 
     bool NCmdParser::parse() {
@@ -108,10 +120,23 @@ namespace neo {
             auto it = m_flags.find(flag);
             if (it != m_flags.end()) {
                 auto& v = it->second;
-                if (checkFlag) {
-                    *v.sFlag = value;
-                } else {
+                if (checkFlag != (v.kind != FlagKind::kBool)) {
+                    return false; // switch given a value, or value flag without one
+                }
+                switch (v.kind) {
+                case FlagKind::kBool:
                     *v.bFlag = true;
+                    break;
+                case FlagKind::kStr:
+                    *v.sFlag = value;
+                    break;
+                case FlagKind::kU32: {
+                    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), *v.uFlag);
+                    if (ec != std::errc {} || end != value.data() + value.size()) {
+                        return false;
+                    }
+                    break;
+                }
                 }
             }
         }
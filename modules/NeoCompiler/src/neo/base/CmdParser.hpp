@@ -11,12 +11,22 @@
 namespace neo {
 
     /// Command line arguments parser
-    /// --[FLAG][=VALUE] or -[FLAG][=VALUE] supporting boolean switch and string value
+    /// --[FLAG][=VALUE] or -[FLAG][=VALUE] supporting boolean switch, string and unsigned value
     class NCmdParser final
     {
-        union CmdFlag {
-            bool* bFlag;
-            std::string* sFlag;
+        enum class FlagKind : u8 {
+            kBool,
+            kStr,
+            kU32
+        };
+
+        struct CmdFlag {
+            FlagKind kind;
+            union {
+                bool* bFlag;
+                std::string* sFlag;
+                u32* uFlag;
+            };
         };
 
     public:
@@ -30,6 +40,8 @@ namespace neo {
         void regBool(const char* flag, bool*);
         /// register string value receiver
         void regStr(const char* flag, std::string&);
+        /// register unsigned integer value receiver
+        void regU32(const char* flag, u32&);
 
     private:
         std::unordered_map<std::string_view, CmdFlag> m_flags;
@@ -0,0 +1,57 @@
+#include "Hash.hpp"
+
+#include <cstring>
+
+namespace neo {
+
+    static constexpr u64 kMul1 = 0x87c37b91114253d5ull;
+    static constexpr u64 kMul2 = 0x4cf5ad432745937full;
+
+    static NE_FORCE_INLINE u64 rotl(u64 v, int r) {
+        return (v << r) | (v >> (64 - r));
+    }
+
+    static NE_FORCE_INLINE u64 mixLane(u64 k) {
+        k *= kMul1;
+        k = rotl(k, 31);
+        return k * kMul2;
+    }
+
+    static NE_FORCE_INLINE u64 finalize(u64 h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+
+    u64 hashBytes(const void* data, psize size, u64 seed)
+    {
+        auto* p = (const u8*)data;
+        // two independent lanes so the multiplies of neighbouring words overlap
+        u64 h1 = seed ^ kMul1;
+        u64 h2 = seed ^ kMul2;
+
+        psize idx = 0;
+        for (; idx + 16 <= size; idx += 16) {
+            u64 k1, k2;
+            std::memcpy(&k1, p + idx, 8);
+            std::memcpy(&k2, p + idx + 8, 8);
+            h1 = rotl(h1 ^ mixLane(k1), 27) * 5 + 0x52dce729;
+            h2 = rotl(h2 ^ mixLane(k2), 31) * 5 + 0x38495ab5;
+        }
+
+        u64 tail[2] {0, 0};
+        std::memcpy(tail, p + idx, size - idx);
+        h1 ^= mixLane(tail[0]);
+        h2 ^= mixLane(tail[1]);
+
+        h1 ^= size;
+        h2 ^= size;
+        h1 += h2;
+        h2 += h1;
+        return finalize(h1) ^ finalize(h2);
+    }
+}
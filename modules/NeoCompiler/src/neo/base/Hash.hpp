@@ -0,0 +1,16 @@
+#pragma once
+
+#include <neo/common.hpp>
+
+#include <string_view>
+
+namespace neo {
+
+    /// 64-bit non-cryptographic hash of a byte range (murmur3 style 8 byte lanes),
+    /// stable across runs and platforms of the same endianness
+    u64 hashBytes(const void* data, psize size, u64 seed = 0);
+
+    NE_FORCE_INLINE u64 hashBytes(std::string_view str, u64 seed = 0) {
+        return hashBytes(str.data(), str.size(), seed);
+    }
+}
@@ -0,0 +1,83 @@
+#include "Interner.hpp"
+
+#include "neo/base/Assert.hpp"
+
+#include <cstring>
+#include <functional>
+
+namespace neo {
+
+    NInterner::NInterner()
+    {
+        // built lazily by the first intern, likely inside some file's scope
+        NMemStats::GlobalScope global {};
+        // the empty string always takes id 0
+        m_next.store(1, std::memory_order_relaxed);
+        pageFor(0)[0] = std::string_view {};
+        m_shards[std::hash<std::string_view>{}({}) & (kShardCount - 1)].ids.emplace(std::string_view {}, 0);
+    }
+
+
+    NInterner::~NInterner()
+    {
+        for (auto& page : m_pages) {
+            delete[] page.load(std::memory_order_relaxed);
+        }
+    }
+
+
+    NInterner& NInterner::global()
+    {
+        static NInterner s_interner {};
+        return s_interner;
+    }
+
+
+    NSymbol NInterner::intern(std::string_view text)
+    {
+        psize hash = std::hash<std::string_view>{}(text);
+        Shard& shard = m_shards[hash & (kShardCount - 1)];
+
+        std::lock_guard lk {shard.lock};
+        auto it = shard.ids.find(text);
+        if (it != shard.ids.end()) {
+            return NSymbol {it->second};
+        }
+
+        u32 id = m_next.fetch_add(1, std::memory_order_relaxed);
+        NE_ASSERT(id != 0); // 32-bit id space exhausted
+
+        {
+            // arena blocks, pages and the map outlive the file that grew them, it is charged its text only
+            NMemStats::GlobalScope global {};
+            char* copy = (char*)shard.text.allocate(text.size(), 1);
+            std::memcpy(copy, text.data(), text.size());
+            std::string_view stored {copy, text.size()};
+
+            // the slot is written before the id escapes the shard lock
+            pageFor(id)[id & (kPageSize - 1)] = stored;
+            shard.ids.emplace(stored, id);
+        }
+        NMemStats::onFileAlloc(MemTag::kSymbols, text.size());
+        return NSymbol {id};
+    }
+
+
+    std::string_view* NInterner::pageFor(u32 id)
+    {
+        auto& slot = m_pages[id >> kPageBits];
+        std::string_view* page = slot.load(std::memory_order_acquire);
+        if (page != nullptr) {
+            return page;
+        }
+
+        auto* fresh = new std::string_view[kPageSize];
+        if (slot.compare_exchange_strong(page, fresh, std::memory_order_acq_rel)) {
+            NMemStats::onAlloc(MemTag::kSymbols, sizeof(std::string_view) * kPageSize);
+            return fresh;
+        }
+        // another shard created it first
+        delete[] fresh;
+        return page;
+    }
+}
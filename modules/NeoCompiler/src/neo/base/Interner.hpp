@@ -0,0 +1,107 @@
+#pragma once
+
+#include <neo/common.hpp>
+#include <neo/base/Arena.hpp>
+#include <neo/base/MemStats.hpp>
+
+#include <atomic>
+#include <compare>
+#include <format>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace neo {
+
+    /// Handle to an interned string, equal text always yields the same id.
+    /// id 0 is the empty symbol.
+    struct NSymbol
+    {
+        u32 id = 0;
+
+        NSymbol() = default;
+        explicit NSymbol(u32 id) : id {id} {}
+
+        bool empty() const {
+            return id == 0;
+        }
+        /// text of the symbol, valid for the lifetime of the process
+        std::string_view str() const;
+
+        bool operator==(const NSymbol&) const = default;
+        auto operator<=>(const NSymbol&) const = default;
+    };
+
+
+    /// Process wide thread-safe string interner
+    /// the table is split into shards with a lock each, the id -> text lookup is lock free.
+    class NInterner final
+    {
+    public:
+        static constexpr u32 kShardCount = 16;
+        static constexpr u32 kPageBits = 16;
+        static constexpr u32 kPageSize = 1u << kPageBits;
+        static constexpr u32 kPageCount = 1u << (32 - kPageBits);
+
+        NInterner();
+        ~NInterner();
+
+        NInterner(const NInterner&) = delete;
+        NInterner& operator=(const NInterner&) = delete;
+
+        static NInterner& global();
+
+        NSymbol intern(std::string_view text);
+        std::string_view lookup(NSymbol sym) const {
+            return m_pages[sym.id >> kPageBits].load(std::memory_order_acquire)[sym.id & (kPageSize - 1)];
+        }
+
+        /// number of distinct strings interned, the empty string included
+        u32 count() const {
+            return m_next.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Shard {
+            std::mutex lock;
+            std::unordered_map<std::string_view, u32, std::hash<std::string_view>, std::equal_to<std::string_view>,
+                               NTrackedAllocator<std::pair<const std::string_view, u32>, MemTag::kSymbols>> ids;
+            NArena text {MemTag::kSymbols};
+        };
+
+        std::string_view* pageFor(u32 id);
+
+    private:
+        Shard m_shards[kShardCount];
+        std::atomic<std::string_view*> m_pages[kPageCount];
+        std::atomic<u32> m_next {0};
+    };
+
+
+    inline std::string_view NSymbol::str() const {
+        return NInterner::global().lookup(*this);
+    }
+
+    /// intern text in the global interner
+    inline NSymbol intern(std::string_view text) {
+        return NInterner::global().intern(text);
+    }
+}
+
+
+template <>
+struct std::hash<neo::NSymbol>
+{
+    std::size_t operator()(const neo::NSymbol& sym) const noexcept {
+        return std::hash<neo::u32>{}(sym.id);
+    }
+};
+
+
+template <>
+struct std::formatter<neo::NSymbol> : std::formatter<std::string_view>
+{
+    auto format(const neo::NSymbol& sym, std::format_context& ctx) const {
+        return std::formatter<std::string_view>::format(sym.str(), ctx);
+    }
+};
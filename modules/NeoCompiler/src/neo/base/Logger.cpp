@@ -1,6 +1,11 @@
 #include "Logger.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <memory>
+#include <thread>
+#include "Assert.hpp"
 #include "StringUtils.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
@@ -11,8 +16,10 @@
 namespace neo {
 
     static std::unique_ptr<spdlog::logger> s_logger;
+    static thread_local NLogCapture* t_capture = nullptr;
+    static thread_local bool t_logWriter = false;
 
-    void Logger::emitLog(const std::string& msg, LogLevel level) {
+    static void writeLine(LogLevel level, const std::string& msg) {
         switch(level)
         {
             case LogLevel::kWarning:
@@ -33,6 +40,167 @@ namespace neo {
         }
     }
 
+
+    /// Bounded multi-producer single-consumer ring (Vyukov): a producer claims a slot with one CAS
+    /// on the tail, the sequence number of the slot tells the writer thread when it is filled.
+    class NLogQueue final {
+    public:
+        explicit NLogQueue(u32 capacity)
+            : m_slots {std::make_unique<Slot[]>(capacity)}
+            , m_mask {capacity - 1}
+        {
+            NE_ASSERT((capacity & m_mask) == 0);
+            for (u32 i = 0; i < capacity; i++) {
+                m_slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+            m_writer = std::thread {[this] { writerLoop(); }};
+        }
+
+        ~NLogQueue() {
+            m_stop.store(true, std::memory_order_release);
+            wake();
+            m_writer.join();
+        }
+
+        void push(NLogRecord&& record) {
+            u64 pos = m_tail.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = m_slots[pos & m_mask];
+                u64 seq = slot.seq.load(std::memory_order_acquire);
+                i64 diff = (i64)seq - (i64)pos;
+                if (diff == 0) {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.record = std::move(record);
+                        slot.seq.store(pos + 1, std::memory_order_release);
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // full, the writer frees slots as it goes
+                    std::this_thread::yield();
+                    pos = m_tail.load(std::memory_order_relaxed);
+                } else {
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+            wake();
+        }
+
+        /// wait until the writer has written everything pushed before the call
+        void flush() {
+            u64 target = m_tail.load(std::memory_order_acquire);
+            u64 done = m_done.load(std::memory_order_acquire);
+            while (done < target) {
+                m_done.wait(done, std::memory_order_acquire);
+                done = m_done.load(std::memory_order_acquire);
+            }
+        }
+
+    private:
+        struct alignas(NE_CACHE_LINE_SIZE) Slot {
+            std::atomic<u64> seq;
+            NLogRecord record;
+        };
+
+        void wake() {
+            // notify costs a syscall only while the writer sleeps
+            m_pushed.fetch_add(1, std::memory_order_release);
+            m_pushed.notify_one();
+        }
+
+        void writerLoop() {
+            t_logWriter = true;
+            u64 head = 0;
+            while (true) {
+                u32 seen = m_pushed.load(std::memory_order_acquire);
+                bool wrote = false;
+                while (true) {
+                    Slot& slot = m_slots[head & m_mask];
+                    if (slot.seq.load(std::memory_order_acquire) != head + 1) {
+                        break;
+                    }
+                    NLogRecord record = std::move(slot.record);
+                    slot.seq.store(head + m_mask + 1, std::memory_order_release);
+                    head++;
+                    writeLine(record.level(), record.format());
+                    wrote = true;
+                }
+
+                // one flush per batch instead of one per line
+                if (wrote) {
+                    s_logger->flush();
+                    m_done.store(head, std::memory_order_release);
+                    m_done.notify_all();
+                    continue;
+                }
+                if (m_stop.load(std::memory_order_acquire)) {
+                    return;
+                }
+                m_pushed.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+    private:
+        std::unique_ptr<Slot[]> m_slots;
+        const u64 m_mask;
+        alignas(NE_CACHE_LINE_SIZE) std::atomic<u64> m_tail {0};
+        alignas(NE_CACHE_LINE_SIZE) std::atomic<u32> m_pushed {0};
+        alignas(NE_CACHE_LINE_SIZE) std::atomic<u64> m_done {0};
+        std::atomic<bool> m_stop {false};
+        std::thread m_writer;
+    };
+
+    static std::unique_ptr<NLogQueue> s_queue;
+    static std::atomic<NLogQueue*> s_async {nullptr};
+
+
+    NLogRecord::~NLogRecord() {
+        if (m_ops != nullptr) {
+            m_ops->destroy(m_args);
+        }
+    }
+
+    NLogRecord::NLogRecord(NLogRecord&& other) noexcept
+        : m_level {other.m_level}, m_fmt {other.m_fmt}, m_ops {other.m_ops}
+    {
+        if (m_ops != nullptr) {
+            m_ops->move(other.m_args, m_args);
+            other.m_ops = nullptr;
+        }
+    }
+
+    NLogRecord& NLogRecord::operator=(NLogRecord&& other) noexcept {
+        if (this != &other) {
+            this->~NLogRecord();
+            ::new ((void*)this) NLogRecord(std::move(other));
+        }
+        return *this;
+    }
+
+
+    bool Logger::deferred() {
+        return t_capture != nullptr || s_async.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    void Logger::emitRecord(NLogRecord&& record) {
+        if (t_capture != nullptr) {
+            t_capture->m_lines.push_back(std::move(record));
+            return;
+        }
+        if (auto* queue = s_async.load(std::memory_order_acquire)) {
+            queue->push(std::move(record));
+            return;
+        }
+        writeLine(record.level(), record.format());
+    }
+
+    void Logger::emitLog(const std::string& msg, LogLevel level) {
+        if (deferred()) {
+            emitRecord(NLogRecord::text(level, msg));
+            return;
+        }
+        writeLine(level, msg);
+    }
+
     Logger::Logger(const char *name, bool record)
     {
         auto fileName = concatStr(name, ".log");
@@ -54,10 +222,91 @@ namespace neo {
         s_logger->flush_on(spdlog::level::trace);
     }
 
+    Logger::~Logger() {
+        stopAsync();
+    }
+
+    void Logger::startAsync(u32 capacity) {
+        if (s_queue) {
+            return;
+        }
+        // the writer flushes per batch
+        s_logger->flush_on(spdlog::level::off);
+        s_queue = std::make_unique<NLogQueue>(std::bit_ceil(std::max(capacity, 2u)));
+        s_async.store(s_queue.get(), std::memory_order_release);
+    }
+
+    void Logger::stopAsync() {
+        if (!s_queue) {
+            return;
+        }
+        // no thread may be logging anymore, the writer drains the ring before it joins
+        s_async.store(nullptr, std::memory_order_release);
+        s_queue.reset();
+        s_logger->flush_on(spdlog::level::trace);
+        s_logger->flush();
+    }
+
+    void Logger::flush() {
+        if (auto* queue = s_async.load(std::memory_order_acquire)) {
+            queue->flush();
+        } else {
+            s_logger->flush();
+        }
+    }
+
+
+    void flushLogsForCrash() {
+        if (!s_logger) {
+            return;
+        }
+        while (auto* capture = t_capture) {
+            capture->end();
+            capture->replay();
+        }
+        // the writer can't wait for itself, its batch so far is in the sinks already
+        auto* queue = s_async.load(std::memory_order_acquire);
+        if (queue != nullptr && !t_logWriter) {
+            queue->flush();
+        }
+        s_logger->flush();
+    }
+
+
+    NLogCapture::~NLogCapture() {
+        end();
+    }
+
+    void NLogCapture::begin() {
+        if (m_active) {
+            return;
+        }
+        m_prev = t_capture;
+        t_capture = this;
+        m_active = true;
+    }
+
+    void NLogCapture::end() {
+        if (!m_active) {
+            return;
+        }
+        t_capture = m_prev;
+        m_prev = nullptr;
+        m_active = false;
+    }
+
+    void NLogCapture::replay() {
+        auto* logger = getNeoDefaultLogger();
+        for (auto& line : m_lines) {
+            logger->emitRecord(std::move(line));
+        }
+        m_lines.clear();
+    }
+
 
     Logger* getNeoDefaultLogger(const char* name, bool useFileRecorder) {
         static Logger logger{name, useFileRecorder};
         return &logger;
     }
 
-} // namespace neo
\ No newline at end of file
+} // namespace neo
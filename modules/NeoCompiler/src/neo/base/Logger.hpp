@@ -1,6 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <new>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 #include <neo/common.hpp>
 #include <format>
 
@@ -14,42 +20,145 @@ namespace neo {
         kTrace
     };
 
+    /// stored copy of a log argument, text is owned so the caller's buffers may go away
+    template <typename T>
+    struct LogStored {
+        using type = T;
+    };
+    template <> struct LogStored<const char*> { using type = std::string; };
+    template <> struct LogStored<char*> { using type = std::string; };
+    template <> struct LogStored<std::string_view> { using type = std::string; };
+
+
+    /// A log call and its arguments, formatted when it is written out.
+    /// Arguments live inline, calls whose arguments don't fit are formatted right away
+    class NLogRecord final {
+    public:
+        static constexpr psize kArgBytes = 80;
+
+        NLogRecord() = default;
+        ~NLogRecord();
+        NLogRecord(NLogRecord&& other) noexcept;
+        NLogRecord& operator=(NLogRecord&& other) noexcept;
+
+        /// fmt must outlive the record, the Log macros pass literals
+        template <typename... Args>
+        static NLogRecord make(LogLevel level, std::string_view fmt, const Args&... args) {
+            using Tuple = std::tuple<typename LogStored<std::decay_t<Args>>::type...>;
+            if constexpr (sizeof(Tuple) <= kArgBytes && alignof(Tuple) <= alignof(std::max_align_t)) {
+                NLogRecord r {level, fmt, &kOps<Tuple>};
+                ::new ((void*)r.m_args) Tuple(args...);
+                return r;
+            } else {
+                return text(level, std::vformat(fmt, std::make_format_args(args...)));
+            }
+        }
+        static NLogRecord text(LogLevel level, std::string msg) {
+            NLogRecord r {level, "{}", &kOps<std::tuple<std::string>>};
+            ::new ((void*)r.m_args) std::tuple<std::string>(std::move(msg));
+            return r;
+        }
+
+        LogLevel level() const {
+            return m_level;
+        }
+        std::string format() const {
+            return m_ops != nullptr ? m_ops->format(m_args, m_fmt) : std::string {};
+        }
+
+    private:
+        struct Ops {
+            std::string (*format)(const void* args, std::string_view fmt);
+            void (*move)(void* from, void* to);
+            void (*destroy)(void* args);
+        };
+
+        template <typename Tuple>
+        static constexpr Ops kOps {
+            [](const void* args, std::string_view fmt) {
+                return std::apply([fmt](const auto&... a) {
+                    return std::vformat(fmt, std::make_format_args(a...));
+                }, *(const Tuple*)args);
+            },
+            [](void* from, void* to) {
+                ::new (to) Tuple(std::move(*(Tuple*)from));
+                ((Tuple*)from)->~Tuple();
+            },
+            [](void* args) {
+                ((Tuple*)args)->~Tuple();
+            }
+        };
+
+        NLogRecord(LogLevel level, std::string_view fmt, const Ops* ops)
+            : m_level {level}, m_fmt {fmt}, m_ops {ops}
+        {
+        }
+
+    private:
+        LogLevel m_level = LogLevel::kInfo;
+        std::string_view m_fmt;
+        const Ops* m_ops = nullptr;
+        alignas(std::max_align_t) std::byte m_args[kArgBytes];
+    };
+
+
     class Logger final {
     private:
+        friend class NLogCapture;
         void emitLog(const std::string& msg, LogLevel level);
+        void emitRecord(NLogRecord&& record);
+        /// records go to a capture or the async writer instead of being formatted here
+        static bool deferred();
+
+        template <typename... Args>
+        NE_FORCE_INLINE void log(LogLevel level, std::format_string<const Args&...> fmtStr, const Args&... args) {
+            if (deferred()) {
+                emitRecord(NLogRecord::make(level, fmtStr.get(), args...));
+            } else {
+                emitLog(std::vformat(fmtStr.get(), std::make_format_args(args...)), level);
+            }
+        }
 
     public:
         Logger(const char* name, bool record);
-        ~Logger() = default;
+        ~Logger();
+
+        /// write from a background thread from now on: calls queue their arguments in a lock-free ring
+        /// and the writer formats and flushes them in batches. A full ring makes callers wait
+        void startAsync(u32 capacity = 4096);
+        /// write out everything queued and return to writing on the calling thread
+        void stopAsync();
+        /// block until everything logged so far is written
+        void flush();
 
         template <typename... Args>
-        NE_FORCE_INLINE void info(std::string_view fmtStr, const Args&... args) {
-            emitLog(std::vformat(fmtStr, std::make_format_args(args...)), LogLevel::kInfo);
+        NE_FORCE_INLINE void info(std::format_string<const Args&...> fmtStr, const Args&... args) {
+            log(LogLevel::kInfo, fmtStr, args...);
         }
         NE_FORCE_INLINE void info(const char* msg) {
             emitLog(msg, LogLevel::kInfo);
         }
 
         template <typename... Args>
-        NE_FORCE_INLINE void warning(std::string_view fmtStr, const Args&... args) {
-            emitLog(std::vformat(fmtStr, std::make_format_args(args...)), LogLevel::kWarning);
+        NE_FORCE_INLINE void warning(std::format_string<const Args&...> fmtStr, const Args&... args) {
+            log(LogLevel::kWarning, fmtStr, args...);
         }
         NE_FORCE_INLINE void warning(const char* msg) {
             emitLog(msg, LogLevel::kWarning);
         }
 
         template <typename... Args>
-        NE_FORCE_INLINE void error(std::string_view fmtStr, Args&&... args) {
-            emitLog(std::vformat(fmtStr, std::make_format_args(args...)), LogLevel::kError);
+        NE_FORCE_INLINE void error(std::format_string<const Args&...> fmtStr, const Args&... args) {
+            log(LogLevel::kError, fmtStr, args...);
         }
         NE_FORCE_INLINE void error(const char* msg) {
             emitLog(msg, LogLevel::kError);
         }
 
         template <typename... Args>
-        NE_FORCE_INLINE void debug(std::string_view fmtStr, const Args&... args) {
+        NE_FORCE_INLINE void debug(std::format_string<const Args&...> fmtStr, const Args&... args) {
 #if NE_DEBUG
-            emitLog(std::vformat(fmtStr, std::make_format_args(args...)), LogLevel::kDebug);
+            log(LogLevel::kDebug, fmtStr, args...);
 #else
             (void)fmtStr;
             ((void)args, ...);
@@ -64,9 +173,9 @@ namespace neo {
         }
 
         template <typename... Args>
-        NE_FORCE_INLINE void trace(std::string_view fmtStr, const Args&... args) {
+        NE_FORCE_INLINE void trace(std::format_string<const Args&...> fmtStr, const Args&... args) {
 #if NE_DEBUG
-            emitLog(std::vformat(fmtStr, std::make_format_args(args...)), LogLevel::kTrace);
+            log(LogLevel::kTrace, fmtStr, args...);
 #else
             (void)fmtStr;
             ((void)args, ...);
@@ -81,7 +190,37 @@ namespace neo {
         }
     };
 
+    /// Holds back the log lines of the current thread between begin() and end(),
+    /// replay() emits them later so parallel jobs can be reported in a fixed order.
+    /// Held lines keep their arguments and are formatted when they are written
+    class NLogCapture final {
+    public:
+        NLogCapture() = default;
+        ~NLogCapture();
+        /// only while inactive, the thread keeps a pointer to an active capture
+        NLogCapture(NLogCapture&&) noexcept = default;
+        NLogCapture& operator=(NLogCapture&&) noexcept = default;
+
+        void begin();
+        void end();
+        void replay();
+
+        bool empty() const {
+            return m_lines.empty();
+        }
+
+    private:
+        friend class Logger;
+
+        std::vector<NLogRecord> m_lines;
+        NLogCapture* m_prev = nullptr;
+        bool m_active = false;
+    };
+
     Logger* getNeoDefaultLogger(const char* name = "neo", bool useFileRecorder = false);
+    /// write out the lines captured on this thread and everything queued for the writer before the process dies,
+    /// safe before the logger exists and on the writer thread itself
+    void flushLogsForCrash();
 }
 
 #define LogInfo(STR, ...)  ::neo::getNeoDefaultLogger()->info(STR, __VA_ARGS__)
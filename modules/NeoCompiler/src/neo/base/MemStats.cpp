@@ -0,0 +1,144 @@
+#include "MemStats.hpp"
+
+#include "neo/base/Logger.hpp"
+
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace neo {
+
+    struct NMemStats::FileStats {
+        std::string name;
+        i64 current[kTagCount] {};
+        i64 peak[kTagCount] {};
+        i64 total = 0;
+        i64 peakTotal = 0;
+    };
+
+    namespace {
+        // records stay until exit, scopes of the same file from two builds get one each
+        struct FileTable {
+            std::mutex lock;
+            std::vector<std::unique_ptr<NMemStats::FileStats>> files;
+        };
+
+        FileTable& fileTable() {
+            static FileTable s_table {};
+            return s_table;
+        }
+
+        std::string formatBytes(i64 bytes) {
+            if (bytes < 0) {
+                return "-" + formatBytes(-bytes);
+            }
+            if (bytes < 1024 * 1024) {
+                return std::format("{:.1f} KB", (double)bytes / 1024.0);
+            }
+            return std::format("{:.1f} MB", (double)bytes / (1024.0 * 1024.0));
+        }
+    }
+
+
+    NMemStats::FileScope::FileScope(std::string_view file)
+        : m_prev {t_file}
+    {
+        if (!enabled()) {
+            return;
+        }
+        auto stats = std::make_unique<FileStats>();
+        stats->name = file;
+        auto& table = fileTable();
+        std::lock_guard guard {table.lock};
+        t_file = table.files.emplace_back(std::move(stats)).get();
+    }
+
+
+    NMemStats::FileScope::~FileScope()
+    {
+        t_file = m_prev;
+    }
+
+
+    void NMemStats::enable()
+    {
+        s_enabled.store(true, std::memory_order_relaxed);
+    }
+
+
+    void NMemStats::fileAlloc(MemTag tag, i64 size)
+    {
+        // only the owning thread touches a file record while its scope is open
+        auto& f = *t_file;
+        u32 idx = (u32)tag;
+        f.current[idx] += size;
+        f.peak[idx] = std::max(f.peak[idx], f.current[idx]);
+        f.total += size;
+        f.peakTotal = std::max(f.peakTotal, f.total);
+    }
+
+
+    std::string_view NMemStats::tagName(MemTag tag)
+    {
+        switch (tag) {
+            case MemTag::kSource:      return "source";
+            case MemTag::kTokens:      return "tokens";
+            case MemTag::kAst:         return "ast";
+            case MemTag::kSymbols:     return "symbols";
+            case MemTag::kDiagnostics: return "diagnostics";
+            case MemTag::kSerializer:  return "serializer";
+            default:                   return "unknown";
+        }
+    }
+
+
+    i64 NMemStats::filePeak(std::string_view file, MemTag tag)
+    {
+        auto& table = fileTable();
+        std::lock_guard guard {table.lock};
+        for (auto it = table.files.rbegin(); it != table.files.rend(); ++it) {
+            if ((*it)->name == file) {
+                return (*it)->peak[(u32)tag];
+            }
+        }
+        return 0;
+    }
+
+
+    void NMemStats::report(u32 maxFiles)
+    {
+        LogInfo("Memory by structure, current / peak :");
+        for (u32 i = 0; i < kTagCount; i++) {
+            auto tag = (MemTag)i;
+            LogInfo("  {:<12} {:>10} / {:>10}", tagName(tag), formatBytes(current(tag)), formatBytes(peak(tag)));
+        }
+
+        auto& table = fileTable();
+        std::lock_guard guard {table.lock};
+        if (table.files.empty()) {
+            return;
+        }
+        std::vector<FileStats*> files {};
+        for (auto& f : table.files) {
+            files.push_back(f.get());
+        }
+        u32 shown = std::min(maxFiles, (u32)files.size());
+        std::partial_sort(files.begin(), files.begin() + shown, files.end(), [](FileStats* a, FileStats* b) {
+            return a->peakTotal > b->peakTotal;
+        });
+
+        LogInfo("Files by peak memory, {} of {} :", shown, files.size());
+        for (u32 i = 0; i < shown; i++) {
+            auto& f = *files[i];
+            std::string tags {};
+            for (u32 t = 0; t < kTagCount; t++) {
+                if (f.peak[t] != 0) {
+                    tags += std::format(" {} {}", tagName((MemTag)t), formatBytes(f.peak[t]));
+                }
+            }
+            LogInfo("  {:>10}  {} :{}", formatBytes(f.peakTotal), f.name, tags);
+        }
+    }
+}
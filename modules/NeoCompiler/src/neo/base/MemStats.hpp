@@ -0,0 +1,157 @@
+#pragma once
+
+#include <neo/common.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+
+namespace neo {
+
+    /// Structures whose memory is accounted
+    enum class MemTag : u8 {
+        kSource,        // source text, heap copies and mappings
+        kTokens,        // NTokenList columns
+        kAst,           // parse arenas
+        kSymbols,       // interned text, id pages and lookup tables
+        kDiagnostics,   // collected diagnostics
+        kSerializer,    // NMemorySerializer buffers
+        kCount
+    };
+
+
+    /// bytes of one tag, a cache line each so busy tags don't share one
+    struct alignas(NE_CACHE_LINE_SIZE) NMemCounter
+    {
+        std::atomic<i64> current {0};
+        std::atomic<i64> peak {0};
+    };
+
+
+    /// Process wide memory accounting per MemTag.
+    /// Totals are always kept, an allocation costs one relaxed add plus a compare for the peak,
+    /// and allocations are counted per block or buffer, never per element.
+    /// After enable() the allocations of a thread inside a FileScope are also added to that file.
+    class NMemStats final
+    {
+    public:
+        static constexpr u32 kTagCount = (u32)MemTag::kCount;
+
+        struct FileStats;
+
+        /// attribute the allocations of the calling thread to file until the scope ends
+        class FileScope
+        {
+        public:
+            explicit FileScope(std::string_view file);
+            ~FileScope();
+
+            FileScope(const FileScope&) = delete;
+            FileScope& operator=(const FileScope&) = delete;
+
+        private:
+            FileStats* m_prev;
+        };
+
+        /// allocations of process wide structures, the open file of the thread is not charged until the scope ends
+        class GlobalScope
+        {
+        public:
+            GlobalScope() : m_prev {t_file} {
+                t_file = nullptr;
+            }
+            ~GlobalScope() {
+                t_file = m_prev;
+            }
+
+            GlobalScope(const GlobalScope&) = delete;
+            GlobalScope& operator=(const GlobalScope&) = delete;
+
+        private:
+            FileStats* m_prev;
+        };
+
+        static void enable();
+        static bool enabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        NE_FORCE_INLINE static void onAlloc(MemTag tag, psize size) {
+            auto& c = s_counters[(u32)tag];
+            i64 now = c.current.fetch_add((i64)size, std::memory_order_relaxed) + (i64)size;
+            i64 peak = c.peak.load(std::memory_order_relaxed);
+            while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+            }
+            if (t_file != nullptr) {
+                fileAlloc(tag, (i64)size);
+            }
+        }
+        NE_FORCE_INLINE static void onFree(MemTag tag, psize size) {
+            s_counters[(u32)tag].current.fetch_sub((i64)size, std::memory_order_relaxed);
+            if (t_file != nullptr) {
+                fileAlloc(tag, -(i64)size);
+            }
+        }
+
+        /// charge the open file its share of a global structure, the global totals are left alone
+        NE_FORCE_INLINE static void onFileAlloc(MemTag tag, psize size) {
+            if (t_file != nullptr) {
+                fileAlloc(tag, (i64)size);
+            }
+        }
+
+        static i64 current(MemTag tag) {
+            return s_counters[(u32)tag].current.load(std::memory_order_relaxed);
+        }
+        static i64 peak(MemTag tag) {
+            return s_counters[(u32)tag].peak.load(std::memory_order_relaxed);
+        }
+        static std::string_view tagName(MemTag tag);
+        /// peak bytes of tag in the last scope opened for file, 0 when there is none
+        static i64 filePeak(std::string_view file, MemTag tag);
+
+        /// log current and peak bytes per tag, then the files with the highest peaks
+        static void report(u32 maxFiles = 10);
+
+    private:
+        static void fileAlloc(MemTag tag, i64 size);
+
+    private:
+        static inline std::atomic<bool> s_enabled {false};
+        static inline NMemCounter s_counters[kTagCount] {};
+        static inline thread_local FileStats* t_file = nullptr;
+    };
+
+
+    /// std allocator that accounts its blocks under Tag
+    template <typename T, MemTag Tag>
+    class NTrackedAllocator
+    {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = NTrackedAllocator<U, Tag>;
+        };
+
+        NTrackedAllocator() noexcept = default;
+        template <typename U>
+        NTrackedAllocator(const NTrackedAllocator<U, Tag>&) noexcept {}
+
+        T* allocate(psize n) {
+            T* p = std::allocator<T>{}.allocate(n);
+            NMemStats::onAlloc(Tag, n * sizeof(T));
+            return p;
+        }
+        void deallocate(T* p, psize n) noexcept {
+            NMemStats::onFree(Tag, n * sizeof(T));
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template <typename U>
+        bool operator==(const NTrackedAllocator<U, Tag>&) const noexcept {
+            return true;
+        }
+    };
+}
@@ -1,9 +1,40 @@
 #include "Serializer.hpp"
+#include "neo/base/MemStats.hpp"
 
 #include <filesystem>
 
 namespace neo {
 
+    u64 NSerializer::readVarint() {
+        u64 v = 0;
+        for (u32 shift = 0; shift < 64; shift += 7) {
+            u8 b = 0;
+            void* vptr = &b;
+            if (read(vptr, 1) != 1) {
+                break;
+            }
+            v |= (u64)(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) {
+                break;
+            }
+        }
+        return v;
+    }
+
+    // decode straight out of a buffer, at most 10 bytes, stops at end
+    static u64 decodeVarint(const char* data, psize size, psize& pos) {
+        u64 v = 0;
+        for (u32 shift = 0; shift < 64 && pos < size; shift += 7) {
+            u8 b = (u8)data[pos++];
+            v |= (u64)(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) {
+                return v;
+            }
+        }
+        return v;
+    }
+
+
     IFileSerializer::IFileSerializer(const char* path)
         : m_stream {}
     {
@@ -55,4 +86,118 @@ namespace neo {
     }
 
 
+    NMemorySerializer::NMemorySerializer(psize capacity) {
+        reserve(capacity);
+    }
+
+    NMemorySerializer::~NMemorySerializer() {
+        NMemStats::onFree(MemTag::kSerializer, m_capacity);
+        std::free(m_data);
+    }
+
+    void NMemorySerializer::grow(psize required) {
+        // geometric growth keeps a long run of small writes amortised O(1)
+        psize capacity = m_capacity < 256 ? 256 : m_capacity;
+        while (capacity < required) {
+            capacity *= 2;
+        }
+        reserve(capacity);
+    }
+
+    void NMemorySerializer::reserve(psize capacity) {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        auto* data = (char*)std::realloc(m_data, capacity);
+        if (data == nullptr) {
+            LogError("[NMemorySerializer] Out of memory, {} bytes requested", capacity);
+            NE_ASSERT(false);
+            return;
+        }
+        NMemStats::onAlloc(MemTag::kSerializer, capacity - m_capacity);
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    void NMemorySerializer::padTo(psize align) {
+        static constexpr char s_zeros[64] {};
+        NE_ASSERT(align <= sizeof(s_zeros));
+        psize n = ((m_pos + align - 1) & ~(align - 1)) - m_pos;
+        if (n != 0) {
+            write((void*)s_zeros, n);
+        }
+    }
+
+    void* NMemorySerializer::read(psize size) {
+        NE_ASSERT(m_pos + size <= m_size);
+        char* ptr = (char*)malloc(size * sizeof(char));
+        std::memcpy(ptr, m_data + m_pos, size);
+        m_pos += size;
+        return ptr;
+    }
+
+    u64 NMemorySerializer::readVarint() {
+        return decodeVarint(m_data, m_size, m_pos);
+    }
+
+    bool NMemorySerializer::flush(const char* path) const {
+        std::ofstream out {path, std::ios::out | std::ios::binary | std::ios::trunc};
+        if (!out.is_open() || !out.write(m_data, (std::streamsize)m_size)) {
+            LogError("[NMemorySerializer] File can't be write -> {}", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool NMemorySerializer::loadFile(const char* path) {
+        std::ifstream in {path, std::ios::in | std::ios::binary | std::ios::ate};
+        if (!in.is_open()) {
+            LogError("[NMemorySerializer] File can't be read -> {}", path);
+            return false;
+        }
+        auto size = (psize)in.tellg();
+        in.seekg(0, std::ios::beg);
+        clear();
+        reserve(size);
+        if (size != 0 && !in.read(m_data, (std::streamsize)size)) {
+            LogError("[NMemorySerializer] File can't be read -> {}", path);
+            return false;
+        }
+        m_size = size;
+        return true;
+    }
+
+
+    NMappedSerializer::NMappedSerializer(const char* path) {
+        open(path);
+    }
+
+    bool NMappedSerializer::open(const char* path) {
+        m_pos = 0;
+        m_good = m_buffer.loadFile(path);
+        if (!m_good) {
+            LogError("[NMappedSerializer] File can't be read -> {}", path);
+        }
+        return m_good;
+    }
+
+    u64 NMappedSerializer::readVarint() {
+        if (m_pos >= m_buffer.size()) {
+            m_good = false;
+            return 0;
+        }
+        return decodeVarint(m_buffer.data(), m_buffer.size(), m_pos);
+    }
+
+    void* NMappedSerializer::read(psize size) {
+        const void* src = view(size);
+        if (src == nullptr) {
+            return nullptr;
+        }
+        void* ptr = malloc(size * sizeof(char));
+        std::memcpy(ptr, src, size);
+        return ptr;
+    }
+
+
 } // namespace lime
\ No newline at end of file
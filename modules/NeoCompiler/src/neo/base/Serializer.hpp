@@ -2,11 +2,18 @@
 
 #include "neo/common.hpp"
 
-#include <string_view>
+#include <cstring>
 #include <fstream>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include "neo/base/Assert.hpp"
+#include "neo/base/Interner.hpp"
 #include "neo/base/Logger.hpp"
+#include "neo/base/SourceBuffer.hpp"
+#include "neo/diagnose/SourceLoc.hpp"
 
 namespace neo {
 
@@ -18,18 +25,74 @@ namespace neo {
     };
 
 
+    /// How integers are stored, reader and writer have to agree on it
+    enum class SerialMode : u8 {
+        kFixed,     // native width, the original layout
+        kCompact    // LEB128 for unsigned, zig-zag + LEB128 for signed, SourceLoc as deltas
+    };
+
+    NE_FORCE_INLINE u64 zigzagEncode(i64 v) {
+        return ((u64)v << 1) ^ (u64)(v >> 63);
+    }
+    NE_FORCE_INLINE i64 zigzagDecode(u64 v) {
+        return (i64)(v >> 1) ^ -(i64)(v & 1);
+    }
+
+
     /// Basic serializer interface for reading & writting
     class NSerializer
     {
     public:
         virtual ~NSerializer() {}
 
+        void setMode(SerialMode mode) {
+            m_mode = mode;
+        }
+        SerialMode getMode() const {
+            return m_mode;
+        }
+        /// last SourceLoc written or read, compact mode stores the next one relative to it
+        SourceLoc& lastLoc() {
+            return m_lastLoc;
+        }
+
     public:
         virtual void write(void* data, psize size) = 0;
+        /// returns a malloc'd copy of the next size bytes, the caller frees it
         virtual void* read(psize size) = 0;
         virtual psize read(void*& ptr, psize size) = 0;
         virtual psize getPos() = 0;
         virtual void setPos(psize pos) = 0;
+        /// LEB128 decode, buffer backed serializers override the byte at a time default
+        virtual u64 readVarint();
+        /// bytes left to read, streams that can't tell report the maximum
+        virtual psize remaining() {
+            return ~(psize)0;
+        }
+        /// a length read from the data is larger than what is left, called before anything is allocated
+        virtual void overrun() {}
+
+        NE_FORCE_INLINE void writeVarint(u64 v) {
+            u8 buf[10];
+            psize n = 0;
+            while (v >= 0x80) {
+                buf[n++] = (u8)(v | 0x80);
+                v >>= 7;
+            }
+            buf[n++] = (u8)v;
+            write(buf, n);
+        }
+        /// length or count as written by write(psize)
+        NE_FORCE_INLINE psize readSize() {
+            if (m_mode == SerialMode::kCompact) {
+                return (psize)readVarint();
+            }
+            // read(psize&) would be ambiguous with read(psize size)
+            psize v = 0;
+            void* vptr = &v;
+            read(vptr, sizeof(psize));
+            return v;
+        }
 
     public:
         NE_FORCE_INLINE void write(const char* str) {
@@ -44,6 +107,10 @@ namespace neo {
             write((psize)str.length());
             write((void*)str.c_str(), sizeof(char) * str.length());
         }
+        /// symbols are stored as their text, ids are only stable within one process
+        NE_FORCE_INLINE void write(NSymbol sym) {
+            write(sym.str());
+        }
         NE_FORCE_INLINE void write(bool v) {
             write((void*)&v, 1);
         }
@@ -51,12 +118,31 @@ namespace neo {
             write((void*)&v, sizeof(i8));
         }
         NE_FORCE_INLINE void write(i16 v) {
+            if (m_mode == SerialMode::kCompact) {
+                writeVarint(zigzagEncode(v));
+                return;
+            }
             write((void*)&v, sizeof(i16));
         }
         NE_FORCE_INLINE void write(i32 v) {
+            if (m_mode == SerialMode::kCompact) {
+                writeVarint(zigzagEncode(v));
+                return;
+            }
+            write((void*)&v, sizeof(v));
+        }
+        NE_FORCE_INLINE void write(u32 v) {
+            if (m_mode == SerialMode::kCompact) {
+                writeVarint(v);
+                return;
+            }
             write((void*)&v, sizeof(v));
         }
         NE_FORCE_INLINE void write(i64 v) {
+            if (m_mode == SerialMode::kCompact) {
+                writeVarint(zigzagEncode(v));
+                return;
+            }
             write((void*)&v, sizeof(i64));
         }
         NE_FORCE_INLINE void write(f32 v) {
@@ -66,20 +152,45 @@ namespace neo {
             write((void*)&v, sizeof(f64));
         }
         NE_FORCE_INLINE void write(psize s) {
+            if (m_mode == SerialMode::kCompact) {
+                writeVarint(s);
+                return;
+            }
             write((void*)&s, sizeof(psize));
         }
         NE_FORCE_INLINE void write(ISerializable* s) {
             s->write(this);
         }
+        /// element count followed by the raw elements, one write for the whole array
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        NE_FORCE_INLINE void write(std::span<const T> items) {
+            write((psize)items.size());
+            write((void*)items.data(), items.size_bytes());
+        }
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        NE_FORCE_INLINE void write(const std::vector<T>& items) {
+            write(std::span<const T> {items});
+        }
 
     public:
         void read(std::string& v) {
-            psize len = 0;
-            read((psize)len);
+            psize len = readSize();
+            if (len > remaining()) {
+                overrun();
+                v.clear();
+                return;
+            }
             v.resize(len);
             void* vptr = v.data();
             read(vptr, len * sizeof(char));
         }
+        void read(NSymbol& v) {
+            std::string text {};
+            read(text);
+            v = intern(text);
+        }
         NE_FORCE_INLINE void read(bool& v) {
             void* vptr = &v;
             read(vptr, sizeof(bool));
@@ -89,14 +200,34 @@ namespace neo {
             read(vptr, sizeof(i8));
         }
         NE_FORCE_INLINE void read(i16& v) {
+            if (m_mode == SerialMode::kCompact) {
+                v = (i16)zigzagDecode(readVarint());
+                return;
+            }
             void* vptr = &v;
             read(vptr, sizeof(i16));
         }
         NE_FORCE_INLINE void read(i32& v) {
+            if (m_mode == SerialMode::kCompact) {
+                v = (i32)zigzagDecode(readVarint());
+                return;
+            }
             void* vptr = &v;
             read(vptr, sizeof(i32));
         }
+        NE_FORCE_INLINE void read(u32& v) {
+            if (m_mode == SerialMode::kCompact) {
+                v = (u32)readVarint();
+                return;
+            }
+            void* vptr = &v;
+            read(vptr, sizeof(u32));
+        }
         NE_FORCE_INLINE void read(i64& v) {
+            if (m_mode == SerialMode::kCompact) {
+                v = (i64)zigzagDecode(readVarint());
+                return;
+            }
             void* vptr = &v;
             read(vptr, sizeof(i64));
         }
@@ -109,12 +240,29 @@ namespace neo {
             read(vptr, sizeof(f64));
         }
         NE_FORCE_INLINE void read(psize& v) {
-            void* vptr = &v;
-            read(vptr, sizeof(psize));
+            v = readSize();
         }
         NE_FORCE_INLINE void read(ISerializable* s) {
             s->read(this);
         }
+        /// counterpart of write(std::span<const T>)
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void read(std::vector<T>& items) {
+            psize count = readSize();
+            if (count > remaining() / sizeof(T)) {
+                overrun();
+                items.clear();
+                return;
+            }
+            items.resize(count);
+            void* vptr = items.data();
+            read(vptr, count * sizeof(T));
+        }
+
+    protected:
+        SerialMode m_mode = SerialMode::kFixed;
+        SourceLoc m_lastLoc {};
     };
 
 
@@ -176,4 +324,187 @@ namespace neo {
     private:
         std::ofstream m_stream;
     };
+
+
+    /// Serializer over a growable contiguous buffer, writes are a bounds check and a memcpy.
+    /// The buffer goes to disk with a single flush, or is filled from a file with loadFile for reading.
+    class NMemorySerializer final : public NSerializer
+    {
+    public:
+        NMemorySerializer() = default;
+        explicit NMemorySerializer(psize capacity);
+        ~NMemorySerializer() override;
+
+        NMemorySerializer(const NMemorySerializer&) = delete;
+        NMemorySerializer& operator=(const NMemorySerializer&) = delete;
+
+    public:
+        using NSerializer::write;
+        using NSerializer::read;
+
+        NE_FORCE_INLINE void write(void* data, psize size) override {
+            // memcpy wants valid pointers even for zero bytes, an empty buffer or vector has none
+            if (size == 0) {
+                return;
+            }
+            if (m_pos + size > m_capacity) {
+                grow(m_pos + size);
+            }
+            std::memcpy(m_data + m_pos, data, size);
+            m_pos += size;
+            if (m_pos > m_size) {
+                m_size = m_pos;
+            }
+        }
+        void* read(psize size) override;
+        NE_FORCE_INLINE psize read(void*& ptr, psize size) override {
+            if (size == 0) {
+                return 0;
+            }
+            NE_ASSERT(m_pos + size <= m_size);
+            std::memcpy(ptr, m_data + m_pos, size);
+            m_pos += size;
+            return size;
+        }
+        NE_FORCE_INLINE psize getPos() override {
+            return m_pos;
+        }
+        NE_FORCE_INLINE void setPos(psize pos) override {
+            NE_ASSERT(pos <= m_size);
+            m_pos = pos;
+        }
+        u64 readVarint() override;
+        NE_FORCE_INLINE psize remaining() override {
+            return m_size - m_pos;
+        }
+
+        /// write zero bytes until the position is a multiple of align (a power of two)
+        void padTo(psize align);
+        void reserve(psize capacity);
+        /// drop the content, the buffer is kept for reuse
+        void clear() {
+            m_size = 0;
+            m_pos = 0;
+        }
+
+        /// write the whole buffer to path in one call
+        bool flush(const char* path) const;
+        /// replace the content with the file at path and rewind
+        bool loadFile(const char* path);
+
+        NE_FORCE_INLINE char* data() {
+            return m_data;
+        }
+        NE_FORCE_INLINE const char* data() const {
+            return m_data;
+        }
+        NE_FORCE_INLINE psize size() const {
+            return m_size;
+        }
+
+    private:
+        void grow(psize required);
+
+    private:
+        char* m_data = nullptr;
+        psize m_size = 0;
+        psize m_pos = 0;
+        psize m_capacity = 0;
+    };
+
+
+    /// Read-only serializer over a mapped file (small files are read in one go, see NSourceBuffer).
+    /// Besides the copying NSerializer reads it hands out views into the mapping,
+    /// they stay valid as long as the serializer lives.
+    /// Reading past the end yields empty results and clears good().
+    class NMappedSerializer final : public NSerializer
+    {
+    public:
+        NMappedSerializer() = default;
+        explicit NMappedSerializer(const char* path);
+        ~NMappedSerializer() override = default;
+
+    public:
+        using NSerializer::read;
+
+        /// map path and rewind, false if it can't be read
+        bool open(const char* path);
+
+        void write(void* data, psize size) override {
+            (void)data; (void)size;
+            LogError("[NMappedSerializer] ReadOnly Serializer");
+            NE_ASSERT(false);
+        }
+        void* read(psize size) override;
+        NE_FORCE_INLINE psize read(void*& ptr, psize size) override {
+            const void* src = view(size);
+            if (src == nullptr) {
+                return 0;
+            }
+            std::memcpy(ptr, src, size);
+            return size;
+        }
+        NE_FORCE_INLINE psize getPos() override {
+            return m_pos;
+        }
+        NE_FORCE_INLINE void setPos(psize pos) override {
+            if (pos > m_buffer.size()) {
+                m_good = false;
+                return;
+            }
+            m_pos = pos;
+        }
+        u64 readVarint() override;
+        NE_FORCE_INLINE psize remaining() override {
+            return m_buffer.size() - m_pos;
+        }
+        NE_FORCE_INLINE void overrun() override {
+            m_good = false;
+        }
+
+        /// pointer to the next size bytes, nullptr when fewer are left
+        NE_FORCE_INLINE const void* view(psize size) {
+            if (size > m_buffer.size() - m_pos) {
+                m_good = false;
+                return nullptr;
+            }
+            const char* p = m_buffer.data() + m_pos;
+            m_pos += size;
+            return p;
+        }
+        /// string written by NSerializer::write(std::string_view) and friends
+        std::string_view readView() {
+            psize len = readSize();
+            auto* p = (const char*)view(len);
+            return p != nullptr ? std::string_view {p, len} : std::string_view {};
+        }
+        /// array written by NSerializer::write(std::span<const T>), the writer keeps the elements
+        /// aligned (NMemorySerializer::padTo before the count), misaligned data reads as empty.
+        /// Compact counts have no fixed width, use read(std::vector<T>&) there
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::span<const T> readSpan() {
+            psize count = readSize();
+            if (count > (m_buffer.size() - m_pos) / sizeof(T) || (m_pos % alignof(T)) != 0) {
+                m_good = false;
+                return {};
+            }
+            return { (const T*)view(count * sizeof(T)), count };
+        }
+
+        NE_FORCE_INLINE bool good() const {
+            return m_good;
+        }
+        NE_FORCE_INLINE const char* data() const {
+            return m_buffer.data();
+        }
+        NE_FORCE_INLINE psize size() const {
+            return m_buffer.size();
+        }
+
+    private:
+        NSourceBuffer m_buffer;
+        psize m_pos = 0;
+        bool m_good = false;
+    };
 }
@@ -0,0 +1,195 @@
+#include "SourceBuffer.hpp"
+
+#include "neo/base/MemStats.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if NE_POSIX
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   include <fstream>
+#endif
+
+namespace neo {
+
+    alignas(NSourceBuffer::kAlignment) const char NSourceBuffer::s_empty[NSourceBuffer::kPadding] {};
+
+
+    NSourceBuffer::~NSourceBuffer()
+    {
+        reset();
+    }
+
+
+    NSourceBuffer::NSourceBuffer(NSourceBuffer&& other) noexcept
+        : m_data {std::exchange(other.m_data, nullptr)}
+        , m_size {std::exchange(other.m_size, 0)}
+        , m_mapSize {std::exchange(other.m_mapSize, 0)}
+    {
+    }
+
+
+    NSourceBuffer& NSourceBuffer::operator=(NSourceBuffer&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_mapSize = std::exchange(other.m_mapSize, 0);
+        }
+        return *this;
+    }
+
+
+    char* NSourceBuffer::allocate(psize size)
+    {
+        reset();
+
+        psize capacity = (size + kPadding + kAlignment - 1) & ~(kAlignment - 1);
+        m_data = (char*)::operator new(capacity, std::align_val_t {kAlignment});
+        m_size = size;
+        NMemStats::onAlloc(MemTag::kSource, capacity);
+        std::memset(m_data + size, 0, capacity - size);
+        return m_data;
+    }
+
+
+    void NSourceBuffer::reset()
+    {
+#if NE_POSIX
+        if (m_mapSize != 0) {
+            NMemStats::onFree(MemTag::kSource, m_mapSize);
+            ::munmap(m_data, m_mapSize);
+        }
+        else
+#endif
+        if (m_data != nullptr) {
+            NMemStats::onFree(MemTag::kSource, (m_size + kPadding + kAlignment - 1) & ~(kAlignment - 1));
+            ::operator delete(m_data, std::align_val_t {kAlignment});
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_mapSize = 0;
+    }
+
+
+#if NE_POSIX
+    bool NSourceBuffer::loadFile(const std::string& path)
+    {
+        reset();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st {};
+        bool r = false;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            psize size = (psize)st.st_size;
+            r = (size >= kMapThreshold && mapFile(fd, size)) || readFile(fd, size);
+        }
+        else {
+            // pipes and character devices have no size up front
+            r = readStream(fd);
+        }
+
+        ::close(fd);
+        if (!r) {
+            reset();
+        }
+        return r;
+    }
+
+
+    bool NSourceBuffer::mapFile(int fd, psize size)
+    {
+        psize page = (psize)::sysconf(_SC_PAGESIZE);
+        psize mapSize = (size + kPadding + page - 1) & ~(page - 1);
+
+        // reserve content + padding as zero pages, then lay the file over the front;
+        // the tail of the last file page and the extra pages read as NUL
+        void* base = ::mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        void* file = ::mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (file == MAP_FAILED) {
+            ::munmap(base, mapSize);
+            return false;
+        }
+        ::posix_madvise(base, size, POSIX_MADV_WILLNEED);
+
+        m_data = (char*)base;
+        m_size = size;
+        m_mapSize = mapSize;
+        NMemStats::onAlloc(MemTag::kSource, mapSize);
+        return true;
+    }
+
+
+    bool NSourceBuffer::readFile(int fd, psize size)
+    {
+        char* buf = allocate(size);
+        psize done = 0;
+        while (done < size) {
+            ssize_t n = ::read(fd, buf + done, size - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            done += (psize)n;
+        }
+        return true;
+    }
+
+
+    bool NSourceBuffer::readStream(int fd)
+    {
+        std::string content {};
+        char chunk[16 * 1024];
+        while (true) {
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                return false;
+            }
+            if (n == 0) {
+                break;
+            }
+            content.append(chunk, (psize)n);
+        }
+
+        std::memcpy(allocate(content.size()), content.data(), content.size());
+        return true;
+    }
+#else
+    bool NSourceBuffer::loadFile(const std::string& path)
+    {
+        reset();
+
+        std::ifstream stm {path, std::ios::binary | std::ios::ate};
+        if (!stm.is_open()) {
+            return false;
+        }
+
+        auto size = (psize)stm.tellg();
+        stm.seekg(0);
+        if (!stm.read(allocate(size), (std::streamsize)size)) {
+            reset();
+            return false;
+        }
+        return true;
+    }
+#endif
+}
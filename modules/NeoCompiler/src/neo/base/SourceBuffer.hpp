@@ -0,0 +1,65 @@
+#pragma once
+
+#include "neo/common.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace neo {
+
+    /// Owning, aligned byte buffer for source text.
+    /// At least kPadding NUL bytes follow the content, so scanners may stop on CHAR_EOF
+    /// or load a whole block across the end without a length check.
+    class NSourceBuffer final
+    {
+    public:
+        static constexpr psize kAlignment = 64;
+        static constexpr psize kPadding = 64;
+        /// regular files from this size on are mapped instead of read
+        static constexpr psize kMapThreshold = 16 * 1024;
+
+        NSourceBuffer() = default;
+        ~NSourceBuffer();
+
+        NSourceBuffer(NSourceBuffer&& other) noexcept;
+        NSourceBuffer& operator=(NSourceBuffer&& other) noexcept;
+        NSourceBuffer(const NSourceBuffer&) = delete;
+        NSourceBuffer& operator=(const NSourceBuffer&) = delete;
+
+    public:
+        /// replace the content with size writable bytes, the padding is already zeroed
+        char* allocate(psize size);
+        /// map or read a whole file, the content is left empty on failure
+        bool loadFile(const std::string& path);
+        void reset();
+
+        NE_FORCE_INLINE bool isMapped() const {
+            return m_mapSize != 0;
+        }
+
+        NE_FORCE_INLINE const char* data() const {
+            return m_data != nullptr ? m_data : s_empty;
+        }
+        NE_FORCE_INLINE psize size() const {
+            return m_size;
+        }
+        NE_FORCE_INLINE bool empty() const {
+            return m_size == 0;
+        }
+        NE_FORCE_INLINE std::string_view view() const {
+            return { data(), m_size };
+        }
+
+    private:
+        bool mapFile(int fd, psize size);
+        bool readFile(int fd, psize size);
+        bool readStream(int fd);
+
+    private:
+        alignas(kAlignment) static const char s_empty[kPadding];
+
+        char* m_data = nullptr;
+        psize m_size = 0;
+        psize m_mapSize = 0;
+    };
+}
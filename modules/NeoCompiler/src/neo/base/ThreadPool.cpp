@@ -0,0 +1,141 @@
+#include "ThreadPool.hpp"
+
+#include "neo/base/Trace.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace neo {
+
+    NThreadPool::NThreadPool(u32 workers)
+    {
+        for (u32 idx = 0; idx <= workers; idx++) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        m_threads.reserve(workers);
+        for (u32 idx = 0; idx < workers; idx++) {
+            m_threads.emplace_back([this, idx] { workerLoop(idx); });
+        }
+    }
+
+
+    NThreadPool::~NThreadPool()
+    {
+        wait();
+        {
+            std::lock_guard lk {m_lock};
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) {
+            t.join();
+        }
+    }
+
+
+    u32 NThreadPool::workersForJobs(u32 jobs)
+    {
+        if (jobs == 0) {
+            jobs = std::max(1u, std::thread::hardware_concurrency());
+        }
+        // the thread calling wait() is the last job slot
+        return jobs - 1;
+    }
+
+
+    void NThreadPool::submit(Task task)
+    {
+        u32 idx = m_next.fetch_add(1, std::memory_order_relaxed) % (u32)m_queues.size();
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            // count before the push so m_queued never drops below the real queue size,
+            // and under m_lock so a worker can't miss the wakeup between its check and its sleep
+            std::lock_guard lk {m_lock};
+            m_queued.fetch_add(1, std::memory_order_release);
+        }
+        {
+            std::lock_guard lk {m_queues[idx]->lock};
+            m_queues[idx]->tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+        m_idle.notify_one();
+    }
+
+
+    void NThreadPool::wait()
+    {
+        u32 self = (u32)m_queues.size() - 1;
+        Task task {};
+        while (m_pending.load(std::memory_order_acquire) != 0) {
+            if (popLocal(self, task) || steal(self, task)) {
+                execute(task);
+                continue;
+            }
+            // everything left is already running on a worker
+            std::unique_lock lk {m_lock};
+            m_idle.wait(lk, [this] { return m_pending.load(std::memory_order_acquire) == 0 || m_queued.load() != 0; });
+        }
+    }
+
+
+    bool NThreadPool::popLocal(u32 idx, Task& out)
+    {
+        auto& q = *m_queues[idx];
+        std::lock_guard lk {q.lock};
+        if (q.tasks.empty()) {
+            return false;
+        }
+        out = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+
+    bool NThreadPool::steal(u32 idx, Task& out)
+    {
+        u32 count = (u32)m_queues.size();
+        for (u32 step = 1; step < count; step++) {
+            auto& q = *m_queues[(idx + step) % count];
+            std::lock_guard lk {q.lock};
+            if (q.tasks.empty()) {
+                continue;
+            }
+            out = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+
+    void NThreadPool::execute(Task& task)
+    {
+        task();
+        task = nullptr;
+        if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard lk {m_lock};
+            m_idle.notify_all();
+        }
+    }
+
+
+    void NThreadPool::workerLoop(u32 idx)
+    {
+        NTrace::setThreadName(std::format("worker {}", idx));
+        Task task {};
+        while (true) {
+            if (popLocal(idx, task) || steal(idx, task)) {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock lk {m_lock};
+            m_wake.wait(lk, [this] { return m_stop || m_queued.load() != 0; });
+            if (m_stop && m_queued.load() == 0) {
+                return;
+            }
+        }
+    }
+}
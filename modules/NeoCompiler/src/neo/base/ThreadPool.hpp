@@ -0,0 +1,67 @@
+#pragma once
+
+#include <neo/common.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neo {
+
+    /// Work-stealing thread pool
+    /// every worker owns a deque, it pops its own tasks LIFO and steals FIFO from the others.
+    /// wait() lets the calling thread execute tasks too, so a pool of 0 workers runs everything serially.
+    class NThreadPool final
+    {
+    public:
+        using Task = std::function<void()>;
+
+        explicit NThreadPool(u32 workers);
+        ~NThreadPool();
+
+        NThreadPool(const NThreadPool&) = delete;
+        NThreadPool& operator=(const NThreadPool&) = delete;
+
+        /// queue a task, tasks are spread round-robin over the worker deques
+        void submit(Task task);
+        /// block until every submitted task has finished
+        void wait();
+
+        u32 workerCount() const {
+            return (u32)m_threads.size();
+        }
+
+        /// worker count for a --jobs value, 0 means one job per hardware thread
+        static u32 workersForJobs(u32 jobs);
+
+    private:
+        struct Queue {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        bool popLocal(u32 idx, Task& out);
+        bool steal(u32 idx, Task& out);
+        void execute(Task& task);
+        void workerLoop(u32 idx);
+
+    private:
+        // one queue per worker plus one for the waiting thread
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_lock;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+
+        std::atomic<u32> m_queued {0};
+        std::atomic<u32> m_pending {0};
+        std::atomic<u32> m_next {0};
+        bool m_stop = false;
+    };
+}
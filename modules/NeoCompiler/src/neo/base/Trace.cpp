@@ -0,0 +1,139 @@
+#include "Trace.hpp"
+
+#include "neo/base/Logger.hpp"
+
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace neo {
+
+    std::atomic<bool> NTrace::s_enabled {false};
+
+    namespace {
+        struct TraceEvent {
+            const char* name;
+            std::string detail;
+            u64 start;
+            u64 end;
+        };
+
+        struct ThreadTrace {
+            u32 id = 0;
+            std::string name;
+            std::vector<TraceEvent> events;
+        };
+
+        // buffers outlive their threads, they are only read by write()
+        struct TraceState {
+            std::mutex lock;
+            std::vector<std::unique_ptr<ThreadTrace>> threads;
+            u64 origin = 0;
+        };
+
+        TraceState& state() {
+            static TraceState s_state {};
+            return s_state;
+        }
+
+        thread_local ThreadTrace* t_thread = nullptr;
+
+        ThreadTrace& local() {
+            if (t_thread == nullptr) {
+                auto& s = state();
+                std::lock_guard guard {s.lock};
+                auto& thread = s.threads.emplace_back(std::make_unique<ThreadTrace>());
+                thread->id = (u32)s.threads.size();
+                t_thread = thread.get();
+            }
+            return *t_thread;
+        }
+
+        void appendEscaped(std::string& out, std::string_view str) {
+            for (char c : str) {
+                if (c == '\"' || c == '\\') {
+                    out.push_back('\\');
+                    out.push_back(c);
+                } else if ((u8)c < 0x20) {
+                    out += std::format("\\u{:04x}", (u32)(u8)c);
+                } else {
+                    out.push_back(c);
+                }
+            }
+        }
+    }
+
+
+    void NTrace::enable()
+    {
+        auto& s = state();
+        {
+            std::lock_guard guard {s.lock};
+            for (auto& thread : s.threads) {
+                thread->events.clear();
+            }
+            s.origin = now();
+        }
+        s_enabled.store(true, std::memory_order_relaxed);
+    }
+
+
+    void NTrace::setThreadName(std::string_view name)
+    {
+        if (enabled()) {
+            local().name = name;
+        }
+    }
+
+
+    void NTrace::record(const char* name, std::string_view detail, u64 startNs, u64 endNs)
+    {
+        local().events.push_back({name, std::string {detail}, startNs, endNs});
+    }
+
+
+    bool NTrace::write(const char* path)
+    {
+        auto& s = state();
+        std::lock_guard guard {s.lock};
+
+        // complete events in microseconds, one metadata event names each thread
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto next = [&] {
+            out += first ? "" : ",\n";
+            first = false;
+        };
+        for (auto& thread : s.threads) {
+            next();
+            out += std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":")", thread->id);
+            appendEscaped(out, thread->name.empty() ? std::format("thread {}", thread->id) : thread->name);
+            out += "\"}}";
+
+            for (auto& e : thread->events) {
+                next();
+                u64 start = e.start > s.origin ? e.start - s.origin : 0;
+                out += std::format(R"({{"name":"{}","cat":"neoc","ph":"X","pid":1,"tid":{},"ts":{}.{:03},"dur":{}.{:03})",
+                                   e.name, thread->id, start / 1000, start % 1000,
+                                   (e.end - e.start) / 1000, (e.end - e.start) % 1000);
+                if (!e.detail.empty()) {
+                    out += R"(,"args":{"file":")";
+                    appendEscaped(out, e.detail);
+                    out += "\"}";
+                }
+                out += "}";
+            }
+        }
+        out += "\n]}\n";
+
+        std::ofstream file {path, std::ios::binary | std::ios::trunc};
+        file.write(out.data(), (std::streamsize)out.size());
+        if (!file) {
+            LogError("Failed to write time trace {}", path);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <neo/common.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace neo {
+
+    /// Scoped time zones of the compiler phases, written as Chrome trace json (chrome://tracing, Perfetto).
+    /// Every thread records into its own buffer, so zones cost nothing but a flag load while tracing is off.
+    class NTrace final
+    {
+    public:
+        /// start recording, zones opened before are dropped
+        static void enable();
+        static bool enabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        /// label of the calling thread in the trace, threads without one are "thread <id>"
+        static void setThreadName(std::string_view name);
+
+        /// record a finished zone of the calling thread, detail goes to the args as the file
+        static void record(const char* name, std::string_view detail, u64 startNs, u64 endNs);
+        /// write everything recorded, call after the traced threads finished
+        static bool write(const char* path);
+
+        static u64 now() {
+            return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        static std::atomic<bool> s_enabled;
+    };
+
+
+    /// zone from construction to the end of the scope. name must be a literal,
+    /// detail has to outlive the zone and is copied when it ends
+    class NTraceZone final
+    {
+    public:
+        explicit NTraceZone(const char* name, std::string_view detail = {})
+            : m_name {name}, m_detail {detail}, m_start {NTrace::enabled() ? NTrace::now() : 0}
+        {
+        }
+        ~NTraceZone() {
+            end();
+        }
+
+        /// close the zone before the scope ends
+        void end() {
+            if (m_start != 0) {
+                NTrace::record(m_name, m_detail, m_start, NTrace::now());
+                m_start = 0;
+            }
+        }
+
+        NTraceZone(const NTraceZone&) = delete;
+        NTraceZone& operator=(const NTraceZone&) = delete;
+
+    private:
+        const char* m_name;
+        std::string_view m_detail;
+        u64 m_start;
+    };
+}
+
+#define _NE_TRACE_CONCAT_HELPER(a, b) a##b
+#define _NE_TRACE_CONCAT(a, b) _NE_TRACE_CONCAT_HELPER(a, b)
+/// NE_TRACE_ZONE("Parse") or NE_TRACE_ZONE("Parse", file.getRelativePath())
+#define NE_TRACE_ZONE(...) ::neo::NTraceZone _NE_TRACE_CONCAT(_neTraceZone, __LINE__) {__VA_ARGS__}
@@ -0,0 +1,260 @@
+#include "Bench.hpp"
+
+#include "neo/base/Logger.hpp"
+#include "neo/base/Timer.hpp"
+#include "neo/compiler/Lexer.hpp"
+#include "neo/compiler/ParsedFile.hpp"
+#include "neo/compiler/Parser.hpp"
+#include "neo/compiler/SourceDir.hpp"
+#include "neo/compiler/SourceFile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace neo {
+
+    namespace {
+        // the shape of dev/testProj/test.neo : imports, comments, modules, functions, statements, classes
+        constexpr std::string_view kLexSample = R"(import test;
+import std.types;
+
+// comment test (single)
+/*
+comment test (multi)
+*/
+
+module moduleTest2 {
+    fun test() {}
+    fun test2() {}
+}
+
+fun funTest3(args : i32) i32 {}
+
+fun ifTest(args : i32) bool {
+    if (args == 0) {
+        return true;
+    } else if (args == 1) {
+        return false;
+    } else {
+        return false;
+    }
+}
+
+fun forTest() i32 {
+    var idx : i32 = 0;
+    for (i : i32; i < 100; i++) {
+        idx += i;
+    }
+    while (idx < 10000) {
+        idx += 1000;
+    }
+    return idx;
+}
+
+class classTest {
+    ctor() {}
+    fun getTest2() i32 {
+        return 100;
+    }
+    field fieldTest2 : i32 {getTest2,}
+    var classVarDef : i32 = 10;
+    val classValDef2 = 10000;
+    static fun createTest() classTest {
+        return classTest();
+    }
+}
+
+enum EnumTest2 : u8 {
+    kTest1 = 10,
+    kTest2
+}
+
+fun tryCatchTest() {
+    try {
+        throw Exception("Test");
+    } catch(e : Exception) {
+        Console.println(e.Message);
+    }
+}
+)";
+
+        // imports and function declarations, what the parser accepts in full so far
+        constexpr std::string_view kParseSample = R"(import a;
+import a.b;
+import a.b.c;
+
+fun test() {
+
+}
+
+fun test1() i32 {
+}
+
+fun test2(a : i32) i32 {
+}
+
+fun test3(a : i32, b : i32) i32 {
+}
+
+fun test4(a : i32*) i32 {
+}
+
+fun test5(a : i32) {
+}
+
+fun test6(a : i32[]) i32 {
+}
+)";
+
+        /// a generated source on disk, removed again when the bench ends
+        class BenchInput final {
+        public:
+            BenchInput(const char* name, std::string_view sample, u32 sizeMB)
+                : m_dirPath {fs::temp_directory_path().string()}
+                , m_dir {m_dirPath.c_str()}
+                , m_file {&m_dir, name}
+            {
+                psize target = (psize)sizeMB * 1024 * 1024;
+                std::string text {};
+                text.reserve(target + sample.size());
+                while (text.size() < target) {
+                    text.append(sample);
+                    text.push_back('\n');
+                }
+                std::ofstream out {m_file.getPath(), std::ios::binary | std::ios::trunc};
+                out.write(text.data(), (std::streamsize)text.size());
+                m_ok = (bool)out;
+            }
+
+            ~BenchInput() {
+                std::error_code ec {};
+                fs::remove(m_file.getPath(), ec);
+            }
+
+            bool ready() {
+                return m_ok && m_file.readAll();
+            }
+
+            NSourceFile& file() {
+                return m_file;
+            }
+
+        private:
+            std::string m_dirPath;
+            NSourceDir m_dir;
+            NSourceFile m_file;
+            bool m_ok = false;
+        };
+
+        bool readSample(const std::string& path, std::string_view fallback, std::string& out) {
+            if (path.empty()) {
+                out = fallback;
+                return true;
+            }
+            std::ifstream in {path, std::ios::binary};
+            std::stringstream ss {};
+            ss << in.rdbuf();
+            out = ss.str();
+            if (!in || out.empty()) {
+                LogError("Failed to read bench input {}", path);
+                return false;
+            }
+            return true;
+        }
+
+        double megaBytesPerSecond(psize bytes, i64 ns) {
+            return ns <= 0 ? 0.0 : (double)bytes / (1024.0 * 1024.0) * 1e9 / (double)ns;
+        }
+    }
+
+
+    bool NBench::lex(const Options& opts)
+    {
+        std::string sample {};
+        if (!readSample(opts.input, kLexSample, sample)) {
+            return false;
+        }
+        BenchInput input {"neo_bench_lex.neo", sample, opts.sizeMB != 0 ? opts.sizeMB : kLexSizeMB};
+        if (!input.ready()) {
+            LogError("Failed to write bench input {}", input.file().getPath());
+            return false;
+        }
+
+        psize bytes = input.file().getContent().size();
+        i64 best = 0;
+        psize tokens = 0;
+        for (u32 run = 0; run < std::max(opts.runs, 1u); run++) {
+            NLexer lex {&input.file()};
+            NTimer t {};
+            bool r = lex.lex();
+            t.end();
+            if (!r) {
+                LogError("Lex bench input failed to lex");
+                return false;
+            }
+            tokens = lex.getTokens().size();
+            LogInfo("  run {} : {:.1f} ms  {:.1f} MB/s", run + 1, (double)t.nanoTime() / 1e6,
+                    megaBytesPerSecond(bytes, t.nanoTime()));
+            if (best == 0 || t.nanoTime() < best) {
+                best = t.nanoTime();
+            }
+        }
+        LogInfo("Lex bench, {} bytes, {} tokens, best of {} : {:.1f} ms  {:.1f} MB/s  {:.0f} tokens/s",
+                bytes, tokens, std::max(opts.runs, 1u), (double)best / 1e6, megaBytesPerSecond(bytes, best),
+                best <= 0 ? 0.0 : (double)tokens * 1e9 / (double)best);
+        return true;
+    }
+
+
+    bool NBench::parse(const Options& opts)
+    {
+        std::string sample {};
+        if (!readSample(opts.input, kParseSample, sample)) {
+            return false;
+        }
+        BenchInput input {"neo_bench_parse.neo", sample, opts.sizeMB != 0 ? opts.sizeMB : kParseSizeMB};
+        if (!input.ready()) {
+            LogError("Failed to write bench input {}", input.file().getPath());
+            return false;
+        }
+
+        psize bytes = input.file().getContent().size();
+        i64 best = 0;
+        psize nodes = 0;
+        for (u32 run = 0; run < std::max(opts.runs, 1u); run++) {
+            NLexer lex {&input.file()};
+            if (!lex.lex()) {
+                LogError("Parse bench input failed to lex");
+                return false;
+            }
+            NParsedFile out {};
+            NParserArgs args {
+                .lexer = &lex,
+                .file = &input.file(),
+                .output = out,
+                .langVer = NSourceFile::kLangVersion,
+            };
+            NParser parser {args};
+            NTimer t {};
+            bool r = parser.parse();
+            t.end();
+            if (!r) {
+                LogError("Parse bench input failed to parse");
+                return false;
+            }
+            nodes = out.Nodes.size();
+            LogInfo("  run {} : {:.1f} ms  {:.1f} MB/s", run + 1, (double)t.nanoTime() / 1e6,
+                    megaBytesPerSecond(bytes, t.nanoTime()));
+            if (best == 0 || t.nanoTime() < best) {
+                best = t.nanoTime();
+            }
+        }
+        LogInfo("Parse bench, {} bytes, {} top-level nodes, best of {} : {:.1f} ms  {:.1f} MB/s",
+                bytes, nodes, std::max(opts.runs, 1u), (double)best / 1e6, megaBytesPerSecond(bytes, best));
+        return true;
+    }
+}
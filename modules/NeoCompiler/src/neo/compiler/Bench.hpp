@@ -0,0 +1,32 @@
+#pragma once
+
+#include "neo/common.hpp"
+
+#include <string>
+
+namespace neo {
+
+    /// Front end throughput on generated input (--bench-lex, --bench-parse).
+    /// A sample source is repeated up to the requested size, written to a temporary file and read back
+    /// like a real source. Every phase runs `runs` times, the best run is reported.
+    /// Compare two lexers or parsers by running the same flags on both builds
+    class NBench final
+    {
+    public:
+        /// default input sizes, the parse tree of 100 MB would peak near 2 GB
+        static constexpr u32 kLexSizeMB = 100;
+        static constexpr u32 kParseSizeMB = 16;
+
+        struct Options {
+            /// size of the generated input in MB, 0 picks the default of the benchmark
+            u32 sizeMB = 0;
+            u32 runs = 3;
+            /// sample file to repeat, empty uses the built-in sample of the benchmark
+            std::string input;
+        };
+
+        static bool lex(const Options& opts);
+        /// times the parser alone, the input is lexed before each run
+        static bool parse(const Options& opts);
+    };
+}
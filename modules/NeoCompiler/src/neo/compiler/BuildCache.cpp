@@ -0,0 +1,261 @@
+#include "BuildCache.hpp"
+
+#include "neo/base/Hash.hpp"
+#include "neo/base/Logger.hpp"
+#include "neo/base/Serializer.hpp"
+#include "neo/base/Timer.hpp"
+#include "neo/compiler/CompileStats.hpp"
+#include "neo/compiler/SourceFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace neo {
+
+    static constexpr char kManifestMagic[4] {'N', 'B', 'C', 'M'};
+
+
+    std::string NBuildCache::manifestPath() const
+    {
+        return m_dir + "/manifest.nbc";
+    }
+
+
+    std::string NBuildCache::artifactPath(const NSourceFile& file, std::string_view ext) const
+    {
+        // files with the same name in different folders must not share artifacts
+        return std::format("{}/{}-{:016x}{}", m_dir, file.getFileName(), hashBytes(file.getPath()), ext);
+    }
+
+
+    bool NBuildCache::fileStamp(const std::string& path, u64& mtime, u64& size)
+    {
+        std::error_code ec {};
+        auto time = fs::last_write_time(path, ec);
+        if (ec) {
+            return false;
+        }
+        size = (u64)fs::file_size(path, ec);
+        mtime = (u64)time.time_since_epoch().count();
+        return !ec;
+    }
+
+
+    void NBuildCache::load(std::string dir, u64 configKey)
+    {
+        m_dir = std::move(dir);
+        m_configKey = configKey;
+        m_entries.clear();
+        m_modules.clear();
+
+        std::error_code ec {};
+        std::string path = manifestPath();
+        if (!fs::exists(path, ec)) {
+            return;
+        }
+
+        NTimer t {};
+        NMappedSerializer in {path.c_str()};
+        in.setMode(SerialMode::kCompact);
+        auto* magic = (const char*)in.view(sizeof(kManifestMagic));
+        u32 version = 0;
+        in.read(version);
+        u64 key = in.readSize();
+        if (magic == nullptr || std::memcmp(magic, kManifestMagic, sizeof(kManifestMagic)) != 0
+            || version != kVersion || key != configKey) {
+            LogDebug("Build cache {} is from another compiler or flags, rebuilding everything", m_dir);
+            return;
+        }
+
+        psize count = in.readSize();
+        for (psize i = 0; i < count && in.good(); i++) {
+            std::string source {};
+            Entry e {};
+            in.read(source);
+            e.mtime = in.readSize();
+            e.size = in.readSize();
+            e.contentHash = in.readSize();
+            e.interfaceHash = in.readSize();
+            in.read(e.module);
+            // every import takes at least a length and a hash byte, a larger count is damage
+            psize imports = in.readSize();
+            if (imports > in.remaining() / 2) {
+                in.overrun();
+                break;
+            }
+            e.imports.resize(imports);
+            e.importHashes.resize(imports);
+            for (psize j = 0; j < e.imports.size() && in.good(); j++) {
+                in.read(e.imports[j]);
+                e.importHashes[j] = in.readSize();
+            }
+            m_entries.emplace(std::move(source), std::move(e));
+        }
+        if (!in.good()) {
+            LogDebug("Build cache {} is damaged, rebuilding everything", m_dir);
+            m_entries.clear();
+        }
+        m_modulesDirty = true;
+        t.end();
+        NCompileStats::countRead(in.size(), t.nanoTime());
+    }
+
+
+    void NBuildCache::retain(const std::unordered_set<std::string>& sources)
+    {
+        // a deleted file must neither stay in the manifest nor keep its module alive
+        std::lock_guard guard {m_lock};
+        std::erase_if(m_entries, [&sources](const auto& item) {
+            return !sources.contains(item.first);
+        });
+        m_modulesDirty = true;
+    }
+
+
+    bool NBuildCache::save()
+    {
+        std::lock_guard guard {m_lock};
+
+        // imports are resolved once every file of the run is built
+        for (auto& source : m_built) {
+            auto& e = m_entries[source];
+            e.importHashes.resize(e.imports.size());
+            for (psize i = 0; i < e.imports.size(); i++) {
+                e.importHashes[i] = interfaceOf(e.imports[i]);
+            }
+        }
+        m_built.clear();
+
+        NTimer t {};
+        NMemorySerializer out {};
+        out.setMode(SerialMode::kCompact);
+        out.write((void*)kManifestMagic, sizeof(kManifestMagic));
+        out.write(kVersion);
+        out.write(m_configKey);
+        out.write((psize)m_entries.size());
+        for (auto& [source, e] : m_entries) {
+            out.write(source);
+            out.write(e.mtime);
+            out.write(e.size);
+            out.write(e.contentHash);
+            out.write(e.interfaceHash);
+            out.write(e.module);
+            out.write((psize)e.imports.size());
+            for (psize i = 0; i < e.imports.size(); i++) {
+                out.write(e.imports[i]);
+                out.write(e.importHashes[i]);
+            }
+        }
+
+        // a build killed halfway leaves the old manifest in place
+        std::string path = manifestPath();
+        std::string tmpPath = path + ".tmp";
+        if (!out.flush(tmpPath.c_str())) {
+            return false;
+        }
+        std::error_code ec {};
+        fs::rename(tmpPath, path, ec);
+        if (ec) {
+            LogError("Failed to write build cache {} : {}", path, ec.message());
+            return false;
+        }
+        t.end();
+        NCompileStats::countWrite(out.size(), t.nanoTime());
+        return true;
+    }
+
+
+    bool NBuildCache::isContentUpToDate(NSourceFile& file, Entry* entry)
+    {
+        std::string source = file.getPath();
+        Entry e {};
+        {
+            std::lock_guard guard {m_lock};
+            auto it = m_entries.find(source);
+            if (it == m_entries.end()) {
+                return false;
+            }
+            e = it->second;
+        }
+
+        u64 mtime = 0;
+        u64 size = 0;
+        std::error_code ec {};
+        if (!fileStamp(source, mtime, size) || !fs::exists(artifactPath(file, ".nmd"), ec)) {
+            return false;
+        }
+        if (entry != nullptr) {
+            *entry = e;
+        }
+        if (mtime == e.mtime && size == e.size) {
+            return true;
+        }
+
+        // touched or rewritten, the content decides
+        if (size != e.size || !file.readAll() || hashBytes(file.getContent()) != e.contentHash) {
+            return false;
+        }
+        std::lock_guard guard {m_lock};
+        auto& stored = m_entries[source];
+        stored.mtime = mtime;
+        return true;
+    }
+
+
+    bool NBuildCache::hasStaleImports(NSourceFile& file)
+    {
+        std::lock_guard guard {m_lock};
+        auto it = m_entries.find(file.getPath());
+        if (it == m_entries.end()) {
+            return true;
+        }
+        auto& e = it->second;
+        for (psize i = 0; i < e.imports.size(); i++) {
+            if (interfaceOf(e.imports[i]) != e.importHashes[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    void NBuildCache::update(NSourceFile& file, Entry entry)
+    {
+        std::string source = file.getPath();
+        std::lock_guard guard {m_lock};
+        m_entries[source] = std::move(entry);
+        m_built.push_back(std::move(source));
+        m_modulesDirty = true;
+    }
+
+
+    u64 NBuildCache::interfaceOf(const std::string& module)
+    {
+        if (m_modulesDirty) {
+            // a module split over several files is the hash of all of them, combined in path order
+            std::unordered_map<std::string_view, std::vector<std::pair<std::string_view, u64>>> parts {};
+            for (auto& [source, e] : m_entries) {
+                if (!e.module.empty()) {
+                    parts[e.module].emplace_back(source, e.interfaceHash);
+                }
+            }
+            m_modules.clear();
+            for (auto& [name, files] : parts) {
+                std::sort(files.begin(), files.end());
+                u64 hash = 0;
+                for (auto& [source, interfaceHash] : files) {
+                    hash = hashBytes(source, hash);
+                    hash = hashBytes(&interfaceHash, sizeof(interfaceHash), hash);
+                }
+                m_modules.emplace(name, hash);
+            }
+            m_modulesDirty = false;
+        }
+        auto it = m_modules.find(module);
+        return it != m_modules.end() ? it->second : 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "neo/common.hpp"
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace neo {
+
+    class NSourceFile;
+
+    /// Persistent record of the last build in a cache directory.
+    /// A source file is up to date when its content, the compiler / flags key and the
+    /// interfaces of the modules it imports are what they were when its artifacts were made,
+    /// such a file is skipped without being read.
+    class NBuildCache final
+    {
+    public:
+        struct Entry {
+            u64 mtime = 0;
+            u64 size = 0;
+            u64 contentHash = 0;
+            /// hash of the .nmd image without the source hash, changes only with the exports
+            u64 interfaceHash = 0;
+            std::string module;
+            std::vector<std::string> imports;
+            /// interface hash of every import when this entry was built, 0 for unknown modules
+            std::vector<u64> importHashes;
+        };
+
+        /// manifest format version
+        static constexpr u32 kVersion = 2;
+
+        /// read the manifest in dir, entries made under another configKey are dropped
+        void load(std::string dir, u64 configKey);
+        /// drop the entries of sources that are not part of this build, call after load
+        void retain(const std::unordered_set<std::string>& sources);
+        /// store the manifest, import hashes of the files built in this run are filled in first
+        bool save();
+
+        const std::string& getDir() const {
+            return m_dir;
+        }
+        u64 getConfigKey() const {
+            return m_configKey;
+        }
+
+        /// source and artifacts are unchanged, imports are not checked. entry gets the stored record
+        bool isContentUpToDate(NSourceFile& file, Entry* entry = nullptr);
+        /// some import exports something else than when file was built
+        bool hasStaleImports(NSourceFile& file);
+
+        /// record a finished build of file, safe to call from compile jobs
+        void update(NSourceFile& file, Entry entry);
+
+        /// artifact path for file, ext includes the dot
+        std::string artifactPath(const NSourceFile& file, std::string_view ext) const;
+
+        /// stat a file, false when it is gone
+        static bool fileStamp(const std::string& path, u64& mtime, u64& size);
+
+    private:
+        std::string manifestPath() const;
+        /// current interface hash of a module over all files declaring it, 0 when none does. Needs m_lock
+        u64 interfaceOf(const std::string& module);
+
+    private:
+        std::string m_dir;
+        u64 m_configKey = 0;
+        std::mutex m_lock;
+        // keyed by source path
+        std::unordered_map<std::string, Entry> m_entries;
+        std::vector<std::string> m_built;
+        // module name -> combined interface hash, rebuilt after updates
+        std::unordered_map<std::string, u64> m_modules;
+        bool m_modulesDirty = true;
+    };
+}
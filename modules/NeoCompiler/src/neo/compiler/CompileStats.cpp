@@ -0,0 +1,285 @@
+#include "CompileStats.hpp"
+
+#include "neo/ast/Visitor.hpp"
+#include "neo/base/Logger.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace neo {
+
+    std::atomic<bool> NCompileStats::s_enabled {false};
+
+    namespace {
+        // sets outlive their threads, merged() reads them after the pool joined
+        struct CounterTable {
+            std::mutex lock;
+            std::vector<std::unique_ptr<NCompileCounters>> threads;
+        };
+
+        CounterTable& counterTable() {
+            static CounterTable s_table {};
+            return s_table;
+        }
+
+        thread_local NCompileCounters* t_counters = nullptr;
+
+        struct NodeCounter : ASTVisitor<NodeCounter> {
+            NCompileCounters& c;
+
+            explicit NodeCounter(NCompileCounters& counters) : c {counters} {}
+
+            VisitAction visitNode(ASTNode* n) {
+                switch (n->getType()) {
+                case kDeclaration:
+                    c.decls[(psize)((ASTDecl*)n)->getDeclKind()]++;
+                    break;
+                case kStatment:
+                    if (((ASTStmt*)n)->getStmtKind() == StmtKind::kExpression) {
+                        c.exprs[(psize)((ASTExpr*)n)->getExprKind()]++;
+                    } else {
+                        c.stmts[(psize)((ASTStmt*)n)->getStmtKind()]++;
+                    }
+                    break;
+                default:
+                    c.typeNodes++;
+                    break;
+                }
+                return VisitAction::kContinue;
+            }
+        };
+
+        double perSecond(u64 count, u64 ns) {
+            return ns == 0 ? 0.0 : (double)count * 1e9 / (double)ns;
+        }
+
+        double megaBytes(u64 bytes) {
+            return (double)bytes / (1024.0 * 1024.0);
+        }
+
+        // kind names without the k prefix
+        std::string_view kindName(std::string_view name) {
+            return name.size() > 1 && name[0] == 'k' ? name.substr(1) : name;
+        }
+
+        /// "name count" pairs of the non zero entries, largest first
+        template <typename NameOf>
+        std::vector<std::pair<std::string_view, u64>> ranked(const u64* counts, psize size, NameOf nameOf) {
+            std::vector<std::pair<std::string_view, u64>> out {};
+            for (psize i = 0; i < size; i++) {
+                if (counts[i] != 0) {
+                    out.emplace_back(nameOf(i), counts[i]);
+                }
+            }
+            std::stable_sort(out.begin(), out.end(), [](auto& a, auto& b) { return a.second > b.second; });
+            return out;
+        }
+
+        std::string joinRanked(const std::vector<std::pair<std::string_view, u64>>& items, psize max) {
+            std::string out {};
+            for (psize i = 0; i < items.size() && i < max; i++) {
+                out += std::format("{}{} {}", i == 0 ? "" : ", ", items[i].first, items[i].second);
+            }
+            return out.empty() ? "none" : out;
+        }
+
+        std::string jsonObject(const std::vector<std::pair<std::string_view, u64>>& items) {
+            std::string out = "{";
+            for (psize i = 0; i < items.size(); i++) {
+                out += std::format("{}\"{}\":{}", i == 0 ? "" : ",", items[i].first, items[i].second);
+            }
+            return out + "}";
+        }
+
+        std::string jsonPhase(u64 bytes, u64 ns, std::string_view unit, u64 units) {
+            std::string out = std::format(R"({{"bytes":{},"seconds":{:.6f},"bytesPerSecond":{:.0f})",
+                                          bytes, (double)ns / 1e9, perSecond(bytes, ns));
+            if (!unit.empty()) {
+                out += std::format(R"(,"{}":{},"{}PerSecond":{:.0f})", unit, units, unit, perSecond(units, ns));
+            }
+            return out + "}";
+        }
+    }
+
+
+    void NCompileCounters::merge(const NCompileCounters& o)
+    {
+        auto add = [](u64* into, const u64* from, psize n) {
+            for (psize i = 0; i < n; i++) {
+                into[i] += from[i];
+            }
+        };
+        files += o.files;
+        lexBytes += o.lexBytes;
+        lexNs += o.lexNs;
+        add(tokens, o.tokens, kTokenTypes);
+        parseBytes += o.parseBytes;
+        parseNs += o.parseNs;
+        add(decls, o.decls, kDeclKinds);
+        add(stmts, o.stmts, kStmtKinds);
+        add(exprs, o.exprs, kExprKinds);
+        typeNodes += o.typeNodes;
+        errors += o.errors;
+        warnings += o.warnings;
+        notes += o.notes;
+        writeFiles += o.writeFiles;
+        writeBytes += o.writeBytes;
+        writeNs += o.writeNs;
+        readFiles += o.readFiles;
+        readBytes += o.readBytes;
+        readNs += o.readNs;
+    }
+
+
+    u64 NCompileCounters::tokenCount() const
+    {
+        u64 n = 0;
+        for (u64 count : tokens) {
+            n += count;
+        }
+        return n;
+    }
+
+
+    u64 NCompileCounters::nodeCount() const
+    {
+        u64 n = typeNodes;
+        for (u64 count : decls) {
+            n += count;
+        }
+        for (u64 count : stmts) {
+            n += count;
+        }
+        for (u64 count : exprs) {
+            n += count;
+        }
+        return n;
+    }
+
+
+    void NCompileStats::enable()
+    {
+        s_enabled.store(true, std::memory_order_relaxed);
+    }
+
+
+    NCompileCounters& NCompileStats::local()
+    {
+        if (t_counters == nullptr) {
+            auto& table = counterTable();
+            std::lock_guard guard {table.lock};
+            t_counters = table.threads.emplace_back(std::make_unique<NCompileCounters>()).get();
+        }
+        return *t_counters;
+    }
+
+
+    NCompileCounters NCompileStats::merged()
+    {
+        NCompileCounters total {};
+        auto& table = counterTable();
+        std::lock_guard guard {table.lock};
+        for (auto& counters : table.threads) {
+            total.merge(*counters);
+        }
+        return total;
+    }
+
+
+    void NCompileStats::countWrite(u64 bytes, u64 ns)
+    {
+        if (enabled()) {
+            auto& c = local();
+            c.writeFiles++;
+            c.writeBytes += bytes;
+            c.writeNs += ns;
+        }
+    }
+
+
+    void NCompileStats::countRead(u64 bytes, u64 ns)
+    {
+        if (enabled()) {
+            auto& c = local();
+            c.readFiles++;
+            c.readBytes += bytes;
+            c.readNs += ns;
+        }
+    }
+
+
+    void NCompileStats::countTokens(NCompileCounters& c, const NTokenList& tokens)
+    {
+        for (psize i = 0; i < tokens.size(); i++) {
+            c.tokens[(psize)tokens.type(i)]++;
+        }
+    }
+
+
+    void NCompileStats::countNodes(NCompileCounters& c, const std::vector<ASTNode*>& nodes)
+    {
+        NodeCounter counter {c};
+        counter.walk(nodes);
+    }
+
+
+    void NCompileStats::report(const NCompileCounters& c, double wallSeconds)
+    {
+        LogInfo("Compile stats, {} files in {:.3f} s, phase times are summed over the threads :", c.files, wallSeconds);
+        LogInfo("  lex    {:>10} tokens {:>9.2f} MB in {:>8.3f} s  {:>12.0f} tokens/s {:>9.2f} MB/s",
+                c.tokenCount(), megaBytes(c.lexBytes), (double)c.lexNs / 1e9,
+                perSecond(c.tokenCount(), c.lexNs), megaBytes((u64)perSecond(c.lexBytes, c.lexNs)));
+        LogInfo("  parse  {:>10} nodes  {:>9.2f} MB in {:>8.3f} s  {:>12.0f} nodes/s  {:>9.2f} MB/s",
+                c.nodeCount(), megaBytes(c.parseBytes), (double)c.parseNs / 1e9,
+                perSecond(c.nodeCount(), c.parseNs), megaBytes((u64)perSecond(c.parseBytes, c.parseNs)));
+        LogInfo("  write  {:>10} files  {:>9.2f} MB in {:>8.3f} s  {:>9.2f} MB/s",
+                c.writeFiles, megaBytes(c.writeBytes), (double)c.writeNs / 1e9,
+                megaBytes((u64)perSecond(c.writeBytes, c.writeNs)));
+        LogInfo("  read   {:>10} files  {:>9.2f} MB in {:>8.3f} s  {:>9.2f} MB/s",
+                c.readFiles, megaBytes(c.readBytes), (double)c.readNs / 1e9,
+                megaBytes((u64)perSecond(c.readBytes, c.readNs)));
+        LogInfo("  diagnostics : {} errors, {} warnings, {} notes", c.errors, c.warnings, c.notes);
+
+        auto tokens = ranked(c.tokens, NCompileCounters::kTokenTypes, [](psize i) { return NToken::typeString((TokenType)i); });
+        auto decls = ranked(c.decls, NCompileCounters::kDeclKinds, [](psize i) { return kindName(getTypeString((DeclKind)i)); });
+        auto stmts = ranked(c.stmts, NCompileCounters::kStmtKinds, [](psize i) { return kindName(getTypeString((StmtKind)i)); });
+        auto exprs = ranked(c.exprs, NCompileCounters::kExprKinds, [](psize i) { return kindName(getTypeString((ExprKind)i)); });
+        LogInfo("  tokens : {}", joinRanked(tokens, 12));
+        LogInfo("  decls  : {}", joinRanked(decls, decls.size()));
+        LogInfo("  stmts  : {}", joinRanked(stmts, stmts.size()));
+        LogInfo("  exprs  : {}", joinRanked(exprs, exprs.size()));
+    }
+
+
+    bool NCompileStats::writeJson(const NCompileCounters& c, double wallSeconds, const char* path)
+    {
+        auto tokens = ranked(c.tokens, NCompileCounters::kTokenTypes, [](psize i) { return NToken::typeString((TokenType)i); });
+        auto decls = ranked(c.decls, NCompileCounters::kDeclKinds, [](psize i) { return kindName(getTypeString((DeclKind)i)); });
+        auto stmts = ranked(c.stmts, NCompileCounters::kStmtKinds, [](psize i) { return kindName(getTypeString((StmtKind)i)); });
+        auto exprs = ranked(c.exprs, NCompileCounters::kExprKinds, [](psize i) { return kindName(getTypeString((ExprKind)i)); });
+
+        std::string out = std::format(R"({{"files":{},"wallSeconds":{:.6f},"phases":{{)", c.files, wallSeconds);
+        out += "\"lex\":" + jsonPhase(c.lexBytes, c.lexNs, "tokens", c.tokenCount());
+        out += ",\"parse\":" + jsonPhase(c.parseBytes, c.parseNs, "nodes", c.nodeCount());
+        out += ",\"write\":" + jsonPhase(c.writeBytes, c.writeNs, "files", c.writeFiles);
+        out += ",\"read\":" + jsonPhase(c.readBytes, c.readNs, "files", c.readFiles);
+        out += std::format(R"(}},"diagnostics":{{"errors":{},"warnings":{},"notes":{}}})", c.errors, c.warnings, c.notes);
+        out += ",\"tokens\":" + jsonObject(tokens);
+        out += ",\"decls\":" + jsonObject(decls);
+        out += ",\"stmts\":" + jsonObject(stmts);
+        out += ",\"exprs\":" + jsonObject(exprs);
+        out += "}\n";
+
+        std::ofstream file {path, std::ios::binary | std::ios::trunc};
+        file.write(out.data(), (std::streamsize)out.size());
+        if (!file) {
+            LogError("Failed to write compile stats {}", path);
+            return false;
+        }
+        return true;
+    }
+}
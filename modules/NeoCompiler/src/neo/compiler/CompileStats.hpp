@@ -0,0 +1,79 @@
+#pragma once
+
+#include "neo/common.hpp"
+#include "neo/ast/Base.hpp"
+#include "neo/compiler/Tokens.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace neo {
+
+    /// Counters of the compile phases, every thread fills its own set
+    struct NCompileCounters
+    {
+        static constexpr psize kTokenTypes = (psize)TokenType::kNew + 1;
+        static constexpr psize kDeclKinds = (psize)DeclKind::kTopLevelDecls + 1;
+        static constexpr psize kStmtKinds = (psize)StmtKind::kDecl + 1;
+        static constexpr psize kExprKinds = (psize)ExprKind::kNew + 1;
+
+        u64 files = 0;
+
+        u64 lexBytes = 0;
+        u64 lexNs = 0;
+        u64 tokens[kTokenTypes] {};
+
+        u64 parseBytes = 0;
+        u64 parseNs = 0;
+        u64 decls[kDeclKinds] {};
+        u64 stmts[kStmtKinds] {};      // expressions count under exprs only
+        u64 exprs[kExprKinds] {};
+        u64 typeNodes = 0;
+
+        u64 errors = 0;
+        u64 warnings = 0;
+        u64 notes = 0;
+
+        // ast caches, module files and the build manifest
+        u64 writeFiles = 0;
+        u64 writeBytes = 0;
+        u64 writeNs = 0;
+        u64 readFiles = 0;
+        u64 readBytes = 0;
+        u64 readNs = 0;
+
+        void merge(const NCompileCounters& other);
+        u64 tokenCount() const;
+        u64 nodeCount() const;
+    };
+
+
+    /// --stats collection. Counting is off until enable(), a thread's counters are plain
+    /// integers only it writes, so parallel jobs share nothing until merged() at the end.
+    class NCompileStats final
+    {
+    public:
+        static void enable();
+        static bool enabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        /// counters of the calling thread
+        static NCompileCounters& local();
+        /// sum over every thread, call after the counting threads finished
+        static NCompileCounters merged();
+
+        /// one artifact of bytes written / read in ns, a no-op while counting is off
+        static void countWrite(u64 bytes, u64 ns);
+        static void countRead(u64 bytes, u64 ns);
+        static void countTokens(NCompileCounters& c, const NTokenList& tokens);
+        static void countNodes(NCompileCounters& c, const std::vector<ASTNode*>& nodes);
+
+        /// log throughput per phase, phase times are summed over the threads
+        static void report(const NCompileCounters& c, double wallSeconds);
+        static bool writeJson(const NCompileCounters& c, double wallSeconds, const char* path);
+
+    private:
+        static std::atomic<bool> s_enabled;
+    };
+}
@@ -1,9 +1,113 @@
 #include "DebugOutput.hpp"
 
+#include "neo/base/Hash.hpp"
+#include "neo/base/StringUtils.hpp"
+#include "neo/base/Trace.hpp"
+#include "neo/compiler/SourceFile.hpp"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
 #include <filesystem>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace neo {
 
+    std::atomic<u32> NDump::s_kinds {0};
+
+    namespace {
+        /// queued text above this makes submit() wait for the writer
+        constexpr psize kMaxQueuedBytes = 64 * 1024 * 1024;
+
+        class DumpWriter final {
+        public:
+            explicit DumpWriter(std::string dir)
+                : m_dir {std::move(dir)}
+            {
+                m_thread = std::thread {[this] { writerLoop(); }};
+            }
+
+            ~DumpWriter() {
+                {
+                    std::lock_guard guard {m_lock};
+                    m_stop = true;
+                }
+                m_wake.notify_one();
+                m_thread.join();
+            }
+
+            const std::string& dir() const {
+                return m_dir;
+            }
+
+            void push(std::string path, std::string text) {
+                std::unique_lock guard {m_lock};
+                m_room.wait(guard, [this] { return m_queuedBytes < kMaxQueuedBytes; });
+                m_queuedBytes += text.size();
+                m_items.push_back({std::move(path), std::move(text)});
+                guard.unlock();
+                m_wake.notify_one();
+            }
+
+        private:
+            struct Item {
+                std::string path;
+                std::string text;
+            };
+
+            void writerLoop() {
+                NTrace::setThreadName("dump writer");
+                std::unique_lock guard {m_lock};
+                while (true) {
+                    m_wake.wait(guard, [this] { return m_stop || !m_items.empty(); });
+                    if (m_items.empty()) {
+                        return;
+                    }
+                    Item item = std::move(m_items.front());
+                    m_items.pop_front();
+                    guard.unlock();
+
+                    writeFile(item);
+
+                    guard.lock();
+                    m_queuedBytes -= item.text.size();
+                    m_room.notify_all();
+                }
+            }
+
+            static void writeFile(const Item& item) {
+                NE_TRACE_ZONE("Write dump", item.path);
+                // the whole dump is one buffer, so it goes out in a single write
+                std::FILE* f = std::fopen(item.path.c_str(), "wb");
+                if (f == nullptr) {
+                    LogError("Failed to open dump file {}", item.path);
+                    return;
+                }
+                std::setvbuf(f, nullptr, _IONBF, 0);
+                if (std::fwrite(item.text.data(), 1, item.text.size(), f) != item.text.size()) {
+                    LogError("Failed to write dump file {}", item.path);
+                }
+                std::fclose(f);
+            }
+
+        private:
+            std::string m_dir;
+            std::mutex m_lock;
+            std::condition_variable m_wake;
+            std::condition_variable m_room;
+            std::deque<Item> m_items;
+            psize m_queuedBytes = 0;
+            bool m_stop = false;
+            std::thread m_thread;
+        };
+
+        std::unique_ptr<DumpWriter> s_writer;
+    }
+
     NFileOutput::NFileOutput(const std::string_view& path)
     {
         if (std::filesystem::exists(path.data())) {
@@ -34,4 +138,62 @@ namespace neo {
         // printm_fs.flags();
         return true;
     }
+
+
+    bool NDump::enable(const std::string& kinds, std::string dir)
+    {
+        std::vector<std::string> names {};
+        splitStr(names, kinds, ',');
+        u32 mask = 0;
+        for (auto& name : names) {
+            u32 kind = 0;
+            while (kind < (u32)DumpKind::kCount && kindName((DumpKind)kind) != name) {
+                kind++;
+            }
+            if (kind == (u32)DumpKind::kCount) {
+                LogError("Unknown dump kind {}, expected tokens or ast", name);
+                return false;
+            }
+            mask |= 1u << kind;
+        }
+        if (mask == 0) {
+            return true;
+        }
+
+        std::error_code ec {};
+        std::filesystem::create_directories(dir, ec);
+        if (ec) {
+            LogError("Failed to create dump dir {} : {}", dir, ec.message());
+            return false;
+        }
+        s_writer = std::make_unique<DumpWriter>(std::move(dir));
+        s_kinds.store(mask, std::memory_order_relaxed);
+        return true;
+    }
+
+
+    void NDump::submit(DumpKind kind, const NSourceFile& file, std::string&& text)
+    {
+        // named like the cache artifacts, files with the same name in different folders get their own
+        std::string path = std::format("{}/{}-{:016x}.{}.txt", s_writer->dir(), file.getFileName(),
+                                       hashBytes(file.getPath()), kindName(kind));
+        s_writer->push(std::move(path), std::move(text));
+    }
+
+
+    void NDump::finish()
+    {
+        s_kinds.store(0, std::memory_order_relaxed);
+        s_writer.reset();
+    }
+
+
+    std::string_view NDump::kindName(DumpKind kind)
+    {
+        switch (kind) {
+            case DumpKind::kTokens: return "tokens";
+            case DumpKind::kAst:    return "ast";
+            default:                return "unknown";
+        }
+    }
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "neo/common.hpp"
+#include <atomic>
 #include <fstream>
 #include <sstream>
+#include <string>
 
 #include "neo/base/Logger.hpp"
 #include "neo/base/Format.hpp"
@@ -52,6 +54,34 @@ namespace neo {
     };
 
 
+    /// Keeps everything in memory, dumps of parallel jobs are written out later in order
+    class NBufferOutput final : public NDebugOutput
+    {
+    public:
+        ~NBufferOutput() override = default;
+
+        void writeLine(const std::string_view& line) override {
+            m_buf.append(line);
+            m_buf.push_back('\n');
+        }
+        void write(const std::string_view& txt) override {
+            m_buf.append(txt);
+        }
+        bool print() override { return true; }
+
+        const std::string& str() const {
+            return m_buf;
+        }
+        /// move the text out, the buffer is empty afterwards
+        std::string take() {
+            return std::move(m_buf);
+        }
+
+    private:
+        std::string m_buf;
+    };
+
+
     class NFileOutput final : public NDebugOutput
     {
     public:
@@ -65,5 +95,37 @@ namespace neo {
     private:
         std::ofstream m_fs;
     };
-    
+
+
+    /// What --dump writes per compiled file
+    enum class DumpKind : u8 {
+        kTokens,    // token list of the lexer
+        kAst,       // debugPrint of the parsed nodes
+        kCount
+    };
+
+
+    /// --dump=tokens,ast : debug dumps of every compiled file, one file per source and kind in the dump dir.
+    /// A job fills an NBufferOutput and submits it whole, a background thread writes the finished
+    /// buffers, so parallel jobs never share a file and the workers never wait on the disk
+    class NDump final
+    {
+    public:
+        /// parse the comma separated kinds and start the writer, false for an unknown kind
+        static bool enable(const std::string& kinds, std::string dir);
+        static bool enabled(DumpKind kind) {
+            return (s_kinds.load(std::memory_order_relaxed) & (1u << (u32)kind)) != 0;
+        }
+
+        /// queue text as the kind dump of file, blocks while too much is queued
+        static void submit(DumpKind kind, const class NSourceFile& file, std::string&& text);
+        /// write out everything queued and stop the writer
+        static void finish();
+
+        static std::string_view kindName(DumpKind kind);
+
+    private:
+        static std::atomic<u32> s_kinds;
+    };
+
 }
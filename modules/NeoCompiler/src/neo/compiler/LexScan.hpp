@@ -0,0 +1,171 @@
+#pragma once
+
+#include "neo/common.hpp"
+
+#include <bit>
+
+#if NE_SIMD_SSE
+#   include <emmintrin.h>
+#   if defined(__AVX2__)
+#       include <immintrin.h>
+#   endif
+#elif NE_SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace neo::scan {
+
+    /// Wide byte-class kernels for the lexer's hot loops.
+    /// Every kernel takes [p, end) and returns the first byte that stops the scan, or end.
+    /// The range must be followed by at least Simd::kWidth readable bytes (NSourceBuffer padding),
+    /// blocks are loaded across end and hits past it are clamped.
+
+#if NE_SIMD_SSE && defined(__AVX2__)
+    struct Simd {
+        using Block = __m256i;
+        static constexpr psize kWidth = 32;
+        static constexpr u32 kBitsPerByte = 1;
+
+        NE_FORCE_INLINE static Block load(const char* p) {
+            return _mm256_loadu_si256((const __m256i*)p);
+        }
+        NE_FORCE_INLINE static u64 eq(Block v, char c) {
+            return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+        }
+        // ' ' or '\t' .. '\r'
+        NE_FORCE_INLINE static u64 space(Block v) {
+            __m256i ctl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+            __m256i isCtl = _mm256_cmpeq_epi8(_mm256_min_epu8(ctl, _mm256_set1_epi8('\r' - '\t')), ctl);
+            __m256i isSp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+            return (u32)_mm256_movemask_epi8(_mm256_or_si256(isCtl, isSp));
+        }
+        static constexpr u64 kAll = 0xFFFFFFFFull;
+    };
+#elif NE_SIMD_SSE
+    struct Simd {
+        using Block = __m128i;
+        static constexpr psize kWidth = 16;
+        static constexpr u32 kBitsPerByte = 1;
+
+        NE_FORCE_INLINE static Block load(const char* p) {
+            return _mm_loadu_si128((const __m128i*)p);
+        }
+        NE_FORCE_INLINE static u64 eq(Block v, char c) {
+            return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+        }
+        NE_FORCE_INLINE static u64 space(Block v) {
+            __m128i ctl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+            __m128i isCtl = _mm_cmpeq_epi8(_mm_min_epu8(ctl, _mm_set1_epi8('\r' - '\t')), ctl);
+            __m128i isSp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+            return (u32)_mm_movemask_epi8(_mm_or_si128(isCtl, isSp));
+        }
+        static constexpr u64 kAll = 0xFFFFull;
+    };
+#elif NE_SIMD_NEON
+    struct Simd {
+        using Block = uint8x16_t;
+        static constexpr psize kWidth = 16;
+        static constexpr u32 kBitsPerByte = 4;
+
+        // narrow a byte mask to 4 bits per lane, neon has no movemask
+        NE_FORCE_INLINE static u64 toMask(uint8x16_t m) {
+            return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        }
+        NE_FORCE_INLINE static Block load(const char* p) {
+            return vld1q_u8((const u8*)p);
+        }
+        NE_FORCE_INLINE static u64 eq(Block v, char c) {
+            return toMask(vceqq_u8(v, vdupq_n_u8((u8)c)));
+        }
+        NE_FORCE_INLINE static u64 space(Block v) {
+            uint8x16_t isCtl = vcleq_u8(vsubq_u8(v, vdupq_n_u8('\t')), vdupq_n_u8('\r' - '\t'));
+            uint8x16_t isSp = vceqq_u8(v, vdupq_n_u8(' '));
+            return toMask(vorrq_u8(isCtl, isSp));
+        }
+        static constexpr u64 kAll = ~0ull;
+    };
+#else
+    struct Simd {
+        using Block = char;
+        static constexpr psize kWidth = 1;
+        static constexpr u32 kBitsPerByte = 1;
+
+        static u64 eq(Block, char) { return 0; }
+        static u64 space(Block) { return 0; }
+        static constexpr u64 kAll = 0;
+    };
+#endif
+
+
+    NE_FORCE_INLINE bool isSpaceByte(char c) {
+        return c == ' ' || (u8)(c - '\t') <= (u8)('\r' - '\t');
+    }
+
+
+    template <typename MaskFn, typename StopFn>
+    NE_FORCE_INLINE const char* findFirst(const char* p, const char* end, MaskFn mask, StopFn stop) {
+#if !NE_SIMD_NONE
+        (void)stop;
+        for (; p < end; p += Simd::kWidth) {
+            u64 m = mask(Simd::load(p));
+            if (m != 0) {
+                const char* hit = p + std::countr_zero(m) / Simd::kBitsPerByte;
+                return hit < end ? hit : end;
+            }
+        }
+        return end;
+#else
+        (void)mask;
+        while (p < end && !stop(*p)) {
+            p++;
+        }
+        return p;
+#endif
+    }
+
+
+    /// first non-whitespace byte
+    NE_FORCE_INLINE const char* skipSpaces(const char* p, const char* end) {
+        // most runs are a separator or an indent, don't pay for a block load
+        for (const char* near = p + 8; p < end && p < near; p++) {
+            if (!isSpaceByte(*p)) {
+                return p;
+            }
+        }
+        return findFirst(p, end,
+            [](auto v) { return ~Simd::space(v) & Simd::kAll; },
+            [](char c) { return !isSpaceByte(c); });
+    }
+
+    /// end of a '//' comment: the first '\r' or '\n'
+    NE_FORCE_INLINE const char* findLineEnd(const char* p, const char* end) {
+        return findFirst(p, end,
+            [](auto v) { return Simd::eq(v, '\n') | Simd::eq(v, '\r'); },
+            [](char c) { return c == '\n' || c == '\r'; });
+    }
+
+    /// end of a '/* */' comment: the '*' of the closing "*/", or end
+    NE_FORCE_INLINE const char* findBlockCommentEnd(const char* p, const char* end) {
+        while (true) {
+            p = findFirst(p, end,
+                [](auto v) { return Simd::eq(v, '*'); },
+                [](char c) { return c == '*'; });
+            if (end - p < 2) {
+                return end;
+            }
+            if (p[1] == '/') {
+                return p;
+            }
+            p++;
+        }
+    }
+
+    /// bytes a string literal body has to stop at: quote, escape, line break or NUL
+    NE_FORCE_INLINE const char* findStringStop(const char* p, const char* end) {
+        return findFirst(p, end,
+            [](auto v) {
+                return Simd::eq(v, '\"') | Simd::eq(v, '\\') | Simd::eq(v, '\n') | Simd::eq(v, '\r') | Simd::eq(v, '\0');
+            },
+            [](char c) { return c == '\"' || c == '\\' || c == '\n' || c == '\r' || c == '\0'; });
+    }
+}
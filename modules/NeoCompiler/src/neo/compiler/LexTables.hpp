@@ -0,0 +1,176 @@
+#pragma once
+
+#include "neo/common.hpp"
+#include "Tokens.hpp"
+
+#include <array>
+#include <string_view>
+
+namespace neo {
+
+    /// Lexer dispatch kind of a single byte, resolved by one table load
+    enum class CharKind : u8 {
+        kInvalid,
+        kSpace,
+        kLetter,
+        kDigit,
+        kOperator,
+        kSlash,
+        kQuote,
+        kDoubleQuote,
+        kEOF
+    };
+
+
+    enum CharFlag : u8 {
+        kCharSpace    = 1 << 0,
+        kCharNewLine  = 1 << 1,
+        kCharDigit    = 1 << 2,
+        kCharHexDigit = 1 << 3,
+        kCharIdStart  = 1 << 4,
+        kCharIdBody   = 1 << 5,
+        kCharOperator = 1 << 6,
+    };
+
+
+    struct NOperatorSpelling {
+        std::string_view text;
+        TokenType type;
+    };
+
+    /// every punctuation / operator the lexer recognises, longest match wins
+    inline constexpr NOperatorSpelling kOperatorSpellings[] = {
+        {"+",   TokenType::kAdd},       {"+=",  TokenType::kAddAssign}, {"++", TokenType::kInc},
+        {"-",   TokenType::kSub},       {"-=",  TokenType::kSubAssign}, {"--", TokenType::kDec},
+        {"->",  TokenType::kArrow},
+        {"*",   TokenType::kMul},       {"*=",  TokenType::kMulAssign},
+        {"/",   TokenType::kDiv},       {"/=",  TokenType::kDivAssign},
+        {"%",   TokenType::kMod},       {"%=",  TokenType::kModAssign},
+
+        {"<",   TokenType::kLt},        {"<=",  TokenType::kLe},
+        {"<<",  TokenType::kShl},       {"<<=", TokenType::kShlAssign},
+        {">",   TokenType::kGt},        {">=",  TokenType::kGe},
+        {">>",  TokenType::kShr},       {">>=", TokenType::kShrAssign},
+        {"=",   TokenType::kAssign},    {"==",  TokenType::kEq},
+        {"!",   TokenType::kLNot},      {"!=",  TokenType::kNeq},
+
+        {"&",   TokenType::kBitAnd},    {"&=",  TokenType::kAndAssign}, {"&&", TokenType::kLAnd},
+        {"|",   TokenType::kBitOr},     {"|=",  TokenType::kOrAssign},  {"||", TokenType::kLOr},
+        {"^",   TokenType::kBitXor},    {"^=",  TokenType::kXorAssign},
+        {"~",   TokenType::kBitNot},
+
+        {"(",   TokenType::kLParen},    {")",   TokenType::kRParen},
+        {"{",   TokenType::kLBraces},   {"}",   TokenType::kRBraces},
+        {"[",   TokenType::kLBracket},  {"]",   TokenType::kRBracket},
+
+        {".",   TokenType::kDot},
+        {":",   TokenType::kColon},     {"::",  TokenType::kDoubleColon},
+        {";",   TokenType::kSemicolon},
+        {",",   TokenType::kComma},
+        {"?",   TokenType::kQuestion},
+    };
+
+
+    struct NCharTable {
+        std::array<CharKind, 256> kind {};
+        std::array<u8, 256> flags {};
+        std::array<u8, 256> opIndex {};   // 0 = not an operator char
+        u32 opCharCount = 1;
+    };
+
+    consteval NCharTable buildCharTable() {
+        NCharTable t {};
+        for (u32 c = 0; c < 256; c++) {
+            t.kind[c] = CharKind::kInvalid;
+        }
+
+        for (char c : {' ', '\t', '\v', '\f', '\r', '\n'}) {
+            t.kind[(u8)c] = CharKind::kSpace;
+            t.flags[(u8)c] |= kCharSpace;
+        }
+        t.flags[(u8)'\n'] |= kCharNewLine;
+#if NE_WINDOWS
+        t.flags[(u8)'\r'] |= kCharNewLine;
+#endif
+
+        for (u32 c = '0'; c <= '9'; c++) {
+            t.kind[c] = CharKind::kDigit;
+            t.flags[c] |= kCharDigit | kCharHexDigit | kCharIdBody;
+        }
+        for (u32 c = 'a'; c <= 'z'; c++) {
+            t.kind[c] = CharKind::kLetter;
+            t.flags[c] |= kCharIdStart | kCharIdBody;
+            t.flags[c - 'a' + 'A'] |= kCharIdStart | kCharIdBody;
+            t.kind[c - 'a' + 'A'] = CharKind::kLetter;
+        }
+        for (u32 c = 'a'; c <= 'f'; c++) {
+            t.flags[c] |= kCharHexDigit;
+            t.flags[c - 'a' + 'A'] |= kCharHexDigit;
+        }
+        t.kind[(u8)'_'] = CharKind::kLetter;
+        t.flags[(u8)'_'] |= kCharIdStart | kCharIdBody;
+
+        for (const auto& op : kOperatorSpellings) {
+            for (char c : op.text) {
+                u8 b = (u8)c;
+                if (t.opIndex[b] == 0) {
+                    t.opIndex[b] = (u8)t.opCharCount++;
+                }
+                t.kind[b] = CharKind::kOperator;
+                t.flags[b] |= kCharOperator;
+            }
+        }
+
+        // comment / literal openers take priority over operator dispatch
+        t.kind[(u8)'/'] = CharKind::kSlash;
+        t.kind[(u8)'\''] = CharKind::kQuote;
+        t.kind[(u8)'\"'] = CharKind::kDoubleQuote;
+        t.kind[0] = CharKind::kEOF;
+        return t;
+    }
+
+    inline constexpr NCharTable kCharTable = buildCharTable();
+    inline constexpr u32 kOpCharCount = kCharTable.opCharCount;
+
+
+    /// Maximal-munch trie over kOperatorSpellings, node 0 is the root
+    struct NOperatorTrie {
+        static constexpr u32 kMaxNodes = 64;
+
+        u8 next[kMaxNodes][kOpCharCount] {};
+        TokenType type[kMaxNodes] {};
+        u32 nodeCount = 1;
+    };
+
+    consteval NOperatorTrie buildOperatorTrie() {
+        NOperatorTrie t {};
+        for (auto& tp : t.type) {
+            tp = TokenType::kUnknown;
+        }
+
+        for (const auto& op : kOperatorSpellings) {
+            u32 node = 0;
+            for (char c : op.text) {
+                u8 idx = kCharTable.opIndex[(u8)c];
+                if (t.next[node][idx] == 0) {
+                    t.next[node][idx] = (u8)t.nodeCount++;
+                }
+                node = t.next[node][idx];
+            }
+            t.type[node] = op.type;
+        }
+        return t;
+    }
+
+    inline constexpr NOperatorTrie kOperatorTrie = buildOperatorTrie();
+    static_assert(kOperatorTrie.nodeCount <= NOperatorTrie::kMaxNodes, "operator trie node pool exhausted");
+
+
+    NE_FORCE_INLINE CharKind charKind(char ch) {
+        return kCharTable.kind[(u8)ch];
+    }
+
+    NE_FORCE_INLINE bool charIs(char ch, u8 flags) {
+        return (kCharTable.flags[(u8)ch] & flags) != 0;
+    }
+}
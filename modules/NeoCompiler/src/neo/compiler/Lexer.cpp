@@ -2,48 +2,15 @@
 
 #include "neo/compiler/DebugOutput.hpp"
 #include "neo/compiler/SourceFile.hpp"
+#include "neo/base/SourceBuffer.hpp"
 
 namespace neo {
 
-    const std::map<char, TokenType> NLexer::s_token_types = {
-        {'+', TokenType::kAdd},
-        {'-', TokenType::kSub},
-        {'*', TokenType::kMul},
-        // {'/', TokenType::kDiv},
-        {'%', TokenType::kMod},
-
-        {'<', TokenType::kLt},
-        {'>', TokenType::kGt},
-        {'=', TokenType::kAssign},
-        {'!', TokenType::kLNot},
-
-        {'&', TokenType::kBitAnd},
-        {'|', TokenType::kBitOr},
-        {'^', TokenType::kBitXor},
-        {'~', TokenType::kBitNot},
-
-        {'(', TokenType::kLParen},
-        {')', TokenType::kRParen},
-        {'{', TokenType::kLBraces},
-        {'}', TokenType::kRBraces},
-        {'[', TokenType::kLBracket},
-        {']', TokenType::kRBracket},
-
-        {'.', TokenType::kDot},
-        {':', TokenType::kColon},
-        {';', TokenType::kSemicolon},
-        {',', TokenType::kComma},
-
-        {'?', TokenType::kQuestion},
-    };
-
-
-#define LEX_TOKEN(TYPE, VALUE) NToken { .type = TYPE, .value = VALUE, .line = m_lex_line, .cursor = m_lex_cursor  }
-
+    static_assert(NSourceBuffer::kPadding >= scan::Simd::kWidth, "source padding must cover one scan block");
 
     NLexer::NLexer(NSourceFile* file)
         : m_tokens{}
-        , m_src{ file->getContent().data() }
+        , m_src{ file->getContent() }
         , m_lex_max{ (u32)m_src.length() }
         , m_source{ file }
     {
@@ -59,220 +26,93 @@ namespace neo {
     bool NLexer::lex()
     {
         m_tokens.clear();
-        m_lex_line = 1;
-        m_lex_cursor = 1;
 
-        do {
+        // every path stops on the CHAR_EOF sentinel after the content
+        while (true) {
             skipSpace();
-            if (m_lex_idx == m_lex_max) {
-                m_tokens.push_back(LEX_TOKEN(TokenType::kEOF, ""));
-                break;
-            }
-
-            char c = m_src[m_lex_idx];
-            // lexer logic
-            if (s_token_types.find(c) != s_token_types.end()) {
-                TokenType type = s_token_types.at(c);
-                char next = m_src[m_lex_idx + 1];
-
-                if (type == TokenType::kAssign) {
-                    if (next == '=') {
-                        pushToken(TokenType::kEq, "==");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kLNot) {
-                    if (next == '=') {
-                        pushToken(TokenType::kNeq, "!=");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kAdd) {
-                    if (next == '=') {
-                        pushToken(TokenType::kAddAssign, "+=");
-                        goto end;
-                    }
-                    else if (next == '+') {
-                        pushToken(TokenType::kInc, "++");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kSub) {
-                    if (next == '=') {
-                        pushToken(TokenType::kSubAssign, "-=");
-                        goto end;
-                    }
-                    else if (next == '-') {
-                        pushToken(TokenType::kDec, "--");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kMul) {
-                    if (next == '=') {
-                        pushToken(TokenType::kMulAssign, "*=");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kColon) {
-                    if (next == ':') {
-                        pushToken(TokenType::kDoubleColon, "::");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kDiv) {
-                    if (next == '=') {
-                        pushToken(TokenType::kDivAssign, "/=");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kMod) {
-                    if (next == '=') {
-                        pushToken(TokenType::kModAssign, "%=");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kLt) {
-                    if (next == '=') {
-                        pushToken(TokenType::kLe, "<=");
-                        goto end;
-                    }
-                    else if (next == '<') {
-                        char third = m_src[m_lex_idx + 2];
-                        if (third == '=') {
-                            pushToken(TokenType::kShlAssign, "<<=");
-                            move();  // move extra once below
-                            goto end;
-                        }
-                        else {
-                            pushToken(TokenType::kShl, "<<");
-                            goto end;
-                        }
-                    }
-                }
-                else if (type == TokenType::kGt) {
-                    if (next == '=') {
-                        pushToken(TokenType::kGe, ">=");
-                        goto end;
-                    }
-                    else if (next == '>') {
-                        char third = m_src[m_lex_idx + 2];
-                        if (third == '=') {
-                            pushToken(TokenType::kShrAssign, ">>=");
-                            move();  // move extra once below
-                            goto end;
-                        }
-                        else {
-                            pushToken(TokenType::kShr, ">>");
-                            goto end;
-                        }
-                    }
-                }
-                else if (type == TokenType::kBitAnd) {
-                    if (next == '=') {
-                        pushToken(TokenType::kAndAssign, "&=");
-                        goto end;
-                    }
-                    else if (next == '&') {
-                        pushToken(TokenType::kLAnd, "&&");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kBitOr) {
-                    if (next == '=') {
-                        pushToken(TokenType::kOrAssign, "|=");
-                        goto end;
-                    }
-                    else if (next == '|') {
-                        pushToken(TokenType::kLOr, "||");
-                        goto end;
-                    }
-                }
-                else if (type == TokenType::kBitXor) {
-                    if (next == '=') {
-                        pushToken(TokenType::kXorAssign, "^=");
-                        goto end;
-                    }
-                }
 
-                m_tokens.push_back(LEX_TOKEN(type, { c }));
-                move();
-                continue;
-            end:
-                move(2);
-                // 额外处理 <<==、>>== 的多字符情况
-                // if ((type == TokenType::kLt || type == TokenType::kGt) && next == m_src[m_lex_idx]) {
-                //     // 多移动一次
-                //     move();
-                // }
-            }
-            else if (c == '/') {
+            char c = getChar(m_lex_idx);
+            switch (charKind(c))
+            {
+            case CharKind::kOperator:
+                lexOperator();
+                break;
+            case CharKind::kSlash: {
                 char next = getChar(m_lex_idx + 1);
                 if (next == '/') {
                     move(2);
-                    auto e = lexComment(true);
-//                    if (!e) {
-//                        LogError("[Lexer] Failed to lex comment");
-//                    }
+                    lexComment(true);
                 }
                 else if (next == '*') {
                     move(2);
-                    auto e = lexComment(false);
-//                    if (!e) {
-//                        LogError("[Lexer] Failed to lex comment");
-//                    }
+                    lexComment(false);
                 }
                 else {
-                    move(1);
-                    m_tokens.push_back(LEX_TOKEN(TokenType::kDiv, "/"));
+                    lexOperator();
                 }
-                continue;
+                break;
             }
-            else if (c == '\'') {
-                if (m_lex_idx + 2 < m_lex_max) {
-                    char c2 = m_src[m_lex_idx + 2];
-                    if (c2 == '\'') {
-                        move(2);
-                        m_tokens.push_back(LEX_TOKEN(TokenType::kCharLit, std::string{ m_src[m_lex_idx + 1] }));
-                        continue;
-                    }
+            case CharKind::kQuote:
+                if (getChar(m_lex_idx + 2) == '\'') {
+                    pushToken(TokenType::kCharLit, m_lex_idx + 1, 1);
+                    move(3);
+                    break;
                 }
-            }
-            else if (c == '\"') {
-                auto txt = lexText();
-                if (!txt) {
+                LogError("[Lexer] unclosed char literal near {}", m_source->locate((u32)m_lex_idx).toString());
+                return false;
+            case CharKind::kDoubleQuote:
+                if (!lexText()) {
                     LogError("Failed to lex text");
                 }
+                break;
+            case CharKind::kDigit:
+                if (!lexNumber()) {
+                    LogError("scan number result -> {}", c);
+                    LogError("{} '{}'", m_source->locate((u32)m_lex_idx).toString(), getLine());
+                }
+                break;
+            case CharKind::kLetter:
+                lexIdentifier();
+                break;
+            case CharKind::kEOF:
+                // an embedded NUL ends the file like the sentinel does
+                pushToken(TokenType::kEOF, m_lex_idx, 0);
+                return true;
+            case CharKind::kSpace:
+            case CharKind::kInvalid:
+                LogError("[Lexer] unexpected symbol near -> {}", c);
+                return false;
             }
-            else if (c == CHAR_EOF) {
-                m_tokens.push_back(LEX_TOKEN(TokenType::kEOF, ""));
+        }
+    }
+
+
+    // maximal munch over kOperatorTrie, one table step per byte
+    bool NLexer::lexOperator()
+    {
+        u32 node = 0;
+        u32 len = 0;
+        u32 matchLen = 0;
+        TokenType type = TokenType::kUnknown;
+
+        while (true) {
+            u8 idx = kCharTable.opIndex[(u8)getChar(m_lex_idx + len)];
+            node = kOperatorTrie.next[node][idx];
+            if (idx == 0 || node == 0) {
                 break;
             }
-            else {
-                if (isDigit(c)) {
-                    bool e = lexNumber();
-                    if (!e) {
-                        LogError("scan number result -> ", c);
-                        LogError("[", m_lex_line, ':', m_lex_cursor, "] '", getLine(), "'");
-                    }
-                }
-                else if (isLetter(c)) {
-                    bool e = lexIdentifier();
-//                    if (!e) {
-//                        LogError("[Lexer] scan identifier result -> ", c);
-//                    }
-                }
-                else if (c == CHAR_EOF) {
-                    m_tokens.push_back(LEX_TOKEN(TokenType::kEOF, ""));
-                    return true;
-                }
-                else {
-                    LogError("[Lexer] unexpected symbol near -> ", c);
-                    return false;
-                }
-                continue;
+            len++;
+            if (kOperatorTrie.type[node] != TokenType::kUnknown) {
+                type = kOperatorTrie.type[node];
+                matchLen = len;
             }
-        } while (m_lex_idx < m_lex_max);
+        }
 
+        if (matchLen == 0) {
+            return false;
+        }
+        pushToken(type, m_lex_idx, matchLen);
+        move(matchLen);
         return true;
     }
 
@@ -282,94 +122,91 @@ namespace neo {
         output.write("Lex result of file : ");
         output.writeLine(m_source->getPath());
         output.writeLine("     ");
-        for (auto& tk : m_tokens) {
+        for (psize idx = 0; idx < m_tokens.size(); idx++) {
             output.write("\t");
-            output.writeLine(tk.toString());
+            output.writeLine(m_tokens.at(idx).toString(m_src));
         }
     }
 
 
-    NToken& NLexer::previousToken()
+    NToken NLexer::previousToken()
     {
         if (m_tk_idx > 0)
             m_tk_idx--;
-        return m_tokens[m_tk_idx];
+        return m_tokens.at(m_tk_idx);
     }
 
 
-    NToken& NLexer::peekPrevious()
+    NToken NLexer::peekPrevious()
     {
         if (m_tk_idx > 0)
-            return m_tokens[m_tk_idx - 1];
+            return m_tokens.at(m_tk_idx - 1);
         return NToken::Invalid;
     }
 
 
-    NToken& NLexer::nextToken()
+    NToken NLexer::nextToken()
     {
         m_tk_idx++;
         if (m_tk_idx >= m_tokens.size())
             m_tk_idx = m_tokens.size() - 1;
-        return m_tokens[m_tk_idx];
+        return m_tokens.at(m_tk_idx);
     }
 
 
-    NToken& NLexer::peekNext()
+    NToken NLexer::peekNext()
     {
         if (m_tk_idx + 1 >= m_tokens.size())
             return NToken::Invalid;
-        return m_tokens[m_tk_idx + 1];
+        return m_tokens.at(m_tk_idx + 1);
     }
 
 
-    NToken& NLexer::current() {
-        if (m_tk_idx < 0 || m_tk_idx >= m_tokens.size()) {
+    NToken NLexer::current() {
+        if (m_tk_idx >= m_tokens.size()) {
             return NToken::Invalid;
         }
-        return m_tokens[m_tk_idx];
+        return m_tokens.at(m_tk_idx);
     }
 
 
     bool NLexer::expectToken(TokenType tp)
     {
-        NToken& tk = peekNext();
-        return tk.type == tp;
+        return peekType() == tp;
     }
 
 
     bool NLexer::lexText()
     {
         u32 start = m_lex_idx + 1;
-        char current;
-        std::string result {};
         move();
 
-        while (m_lex_idx < m_lex_max) {
-            current = getChar(m_lex_idx);
-            if (current == 0 || current == '\r' || current == '\n') {
-                char prev = getChar(m_lex_idx - 1);
-                if (prev != '\\') {
-                    LogError("[Lexer] expect another quotation mark before end of file or newline");
-                    return false;
-                }
-//                u32 endLine = m_lex_idx;
-                auto linePart = subString(start, m_lex_idx - start);
-                result.append(linePart);
-                move();
-                start = m_lex_idx;
+        // the token spans the raw literal body, escapes are resolved by consumers
+        const char* base = m_src.data();
+        const char* end = base + m_lex_max;
+        const char* p = base + m_lex_idx;
+        while (true) {
+            p = scan::findStringStop(p, end);
+            if (p == end) {
+                break;
+            }
+            if (*p == '\\') {
+                // escaped byte, including a line continuation
+                p = end - p > 2 ? p + 2 : end;
                 continue;
             }
-            if (current == '\"') {
-                auto str = subString(start, m_lex_idx - start);
-                result.append(str);
-                move();
-                pushToken(TokenType::kStringLit, result);
+            if (*p == '\"') {
+                pushToken(TokenType::kStringLit, start, (p - base) - start);
+                m_lex_idx = p - base + 1;
                 return true;
             }
-            move();
+            m_lex_idx = p - base;
+            LogError("[Lexer] expect another quotation mark before end of file or newline");
+            return false;
         }
 
-        pushToken(TokenType::kStringLit, result);
+        m_lex_idx = m_lex_max;
+        pushToken(TokenType::kStringLit, start, m_lex_idx - start);
         return true;
     }
 
@@ -384,20 +221,19 @@ namespace neo {
             char next = getChar(m_lex_idx + 1);
             if (next == 'X' || next == 'x') {
                 move(2);
-                while (m_lex_idx < m_lex_max && isHexDigit(m_src[m_lex_idx]) && IS_NEW_LINE(m_src[m_lex_idx])) {
+                while (isHexDigit(getChar(m_lex_idx))) {
                     move();
                 }
-                auto hex = subString(start, m_lex_idx - start);
-                pushToken(TokenType::kHexLit, hex);
+                pushToken(TokenType::kHexLit, start, m_lex_idx - start);
                 return true;
             }
         }
         if (!isDigit(first)) {
             return false;
         }
-        while (m_lex_idx < m_lex_max) {
-            char current = m_src[m_lex_idx];
-            if (!isDigit(current) || current == '\n' || current == '\r' || current == 0) {
+        while (true) {
+            char current = getChar(m_lex_idx);
+            if (!isDigit(current)) {
                 break;
             }
 //TODO            else if (current == '.') {
@@ -407,12 +243,12 @@ namespace neo {
 //            }
             move();
         }
-        auto number = subString(start, m_lex_idx - start);
-        if (number.find('.') != std::string::npos) {
-            pushToken(TokenType::kFloatLit, number);
+        auto number = m_src.substr(start, m_lex_idx - start);
+        if (number.find('.') != std::string_view::npos) {
+            pushToken(TokenType::kFloatLit, start, number.length());
         }
         else {
-            pushToken(TokenType::kIntLit, number);
+            pushToken(TokenType::kIntLit, start, number.length());
         }
         return true;
     }
@@ -422,60 +258,40 @@ namespace neo {
     {
         u32 start = m_lex_idx;
 
-        while (m_lex_idx < m_lex_max && isLetter(m_src[m_lex_idx]) || isDigit(m_src[m_lex_idx])) {
+        while (charIs(getChar(m_lex_idx), kCharIdBody)) {
             move();
         }
 
-        auto idType = subString(start, m_lex_idx - start);
-        auto type = NToken::checkIdentifier(idType.c_str());
+        auto idType = m_src.substr(start, m_lex_idx - start);
+        auto type = NToken::checkIdentifier(idType);
         if (type != TokenType::kUnknown) {
-            pushToken(type, idType);
+            pushToken(type, start, idType.length());
             return true;
         }
 
-        pushToken(TokenType::kIdentifier, idType);
+        pushToken(TokenType::kIdentifier, start, idType.length());
         return true;
     }
 
 
     bool NLexer::lexComment(bool doubleSlash)
     {
+        const char* base = m_src.data();
+        const char* end = base + m_lex_max;
+
         if (doubleSlash) {
-//            u32 start = m_lex_idx;
-            while (m_lex_idx < m_lex_max) {
-                char ahead = getChar(m_lex_idx);
-                if (ahead == CHAR_EOF || ahead == CHAR_CR || ahead == CHAR_LF) {
-                    break;
-                }
-                move();
-            }
-            // pushToken(TokenType::CommentSingleLine, m_src.substr(start, m_lex_idx - start));
+            m_lex_idx = scan::findLineEnd(base + m_lex_idx, end) - base;
             return true;
         }
-        /* */
 
-//        u32 start = m_lex_idx;
-        while (m_lex_idx < m_lex_max) {
-            char current = getChar(m_lex_idx);
-            if (current == '*') {
-                char next = getChar(m_lex_idx + 1);
-                if (next == '/') {
-                    move(2);
-                    break;
-                }
-            }
-            if (IS_NEW_LINE(current)) {
-                m_lex_line++;
-                m_lex_cursor = 0;
-            }
-            move();
-        } //TODO how about colum ? line ? fix it later
-        // pushToken(TokenType::CommentMultiLine, m_src.substr(start, m_lex_idx - start));
+        /* */
+        const char* close = scan::findBlockCommentEnd(base + m_lex_idx, end);
+        m_lex_idx = close == end ? m_lex_max : close - base + 2;
         return true;
     }
 
 
-    std::string NLexer::getLine()
+    std::string_view NLexer::getLine()
     {
         u32 idx = m_lex_idx;
 
@@ -486,7 +302,6 @@ namespace neo {
             }
         }
         u32 start = m_lex_idx + 1;
-        m_lex_cursor = idx;
 
         while (m_lex_idx < m_lex_max) {
             m_lex_idx++;
@@ -494,7 +309,7 @@ namespace neo {
                 break;
             }
         }
-        auto str = subString(start, m_lex_idx - start);
+        auto str = m_src.substr(start, m_lex_idx - start);
         m_lex_idx = idx;
         return str;
     }
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "Tokens.hpp"
+#include "LexTables.hpp"
+#include "LexScan.hpp"
 
-#include <map>
 #include <string>
 #include <vector>
 
@@ -21,15 +22,15 @@ namespace neo {
 #endif
 
     NE_FORCE_INLINE bool isDigit(char ch) {
-        return ch >= '0' && ch <= '9';
+        return charIs(ch, kCharDigit);
     }
 
     NE_FORCE_INLINE bool isHexDigit(char ch) {
-        return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+        return charIs(ch, kCharHexDigit);
     }
     
     NE_FORCE_INLINE bool isLetter(char ch) {
-        return ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+        return charIs(ch, kCharIdStart);
     }
 
     NE_FORCE_INLINE i64 toNumber(char digit) {
@@ -50,34 +51,32 @@ namespace neo {
         bool lex();
         void debugPrint(class NDebugOutput& output);
 
+        const NTokenList& getTokens() const {
+            return m_tokens;
+        }
+
     public:
-        NToken& previousToken();
-        NToken& peekPrevious();
-        NToken& nextToken();
-        NToken& peekNext();
-        NToken& current();
+        NToken previousToken();
+        NToken peekPrevious();
+        NToken nextToken();
+        NToken peekNext();
+        NToken current();
         bool expectToken(TokenType);
 
+        NE_FORCE_INLINE TokenType currentType() const {
+            return m_tk_idx < m_tokens.size() ? m_tokens.type(m_tk_idx) : TokenType::kUnknown;
+        }
+        NE_FORCE_INLINE TokenType peekType() const {
+            return m_tk_idx + 1 < m_tokens.size() ? m_tokens.type(m_tk_idx + 1) : TokenType::kUnknown;
+        }
+
+        NE_FORCE_INLINE std::string_view tokenText(const NToken& tk) const {
+            return tk.value(m_src);
+        }
+
     private:
         NE_FORCE_INLINE void skipSpace() {
-            do {
-                char c = m_src[m_lex_idx];
-                if (!isspace(c)) {
-                    break;
-                }
-
-                if (IS_NEW_LINE(c)) {
-                    m_lex_line++;
-                    m_lex_cursor = 0;
-                }
-
-                m_lex_idx++;
-                m_lex_cursor++;
-            } while (m_lex_idx < m_lex_max);
-        }
-        NE_FORCE_INLINE std::string subString(u32 idx, u32 len) {
-            return idx < m_lex_max && idx + len < m_lex_max ?
-                std::string{ m_src.data() + sizeof(char) * idx, len } : "";
+            m_lex_idx = scan::skipSpaces(m_src.data() + m_lex_idx, m_src.data() + m_lex_max) - m_src.data();
         }
         bool checkMatch(const std::string_view& token) {
             if (m_lex_idx + token.length() < m_lex_max)
@@ -86,18 +85,17 @@ namespace neo {
             return origin == token;
         }
 
-        NE_FORCE_INLINE char getChar(u32 idx) const {
-            return idx > m_lex_max ? ' ' : m_src[idx];
+        // the source is NUL padded past m_lex_max, look-ahead needs no bounds check
+        NE_FORCE_INLINE char getChar(psize idx) const {
+            return m_src.data()[idx];
         }
 
         NE_FORCE_INLINE void move(u32 idx) {
             m_lex_idx += idx;
-            m_lex_cursor += idx;
         }
 
         NE_FORCE_INLINE void move() {
             m_lex_idx += 1;
-            m_lex_cursor += 1;
         }
 
         NE_FORCE_INLINE void waitToLineEnd() {
@@ -106,33 +104,25 @@ namespace neo {
             }
         }
 
-        NE_FORCE_INLINE void pushToken(TokenType type, const std::string& str) {
-            m_tokens.push_back(NToken {
-                .type = type,
-                .value = str,
-                .line = m_lex_line,
-                .cursor = m_lex_cursor,
-            });
+        NE_FORCE_INLINE void pushToken(TokenType type, psize start, psize len) {
+            m_tokens.push(type, (u32)start, (u32)len);
         }
 
+        bool lexOperator();
         bool lexText();
         bool lexNumber();
         bool lexIdentifier();
         bool lexComment(bool doubleSlash);
 
-        std::string getLine();
+        std::string_view getLine();
 
     private:
         std::string_view m_src;
-        std::vector<NToken> m_tokens;
+        NTokenList m_tokens;
         NSourceFile* m_source;
 
         psize m_tk_idx = 0;
-        psize m_lex_line = 0;
         psize m_lex_idx = 0;
         psize m_lex_max = 0;
-        psize m_lex_cursor = 0;
-
-        const static std::map<char, TokenType> s_token_types;
     };
 }
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include "ModuleFile.hpp"
+
+#include "neo/ast/Decl.hpp"
+#include "neo/ast/Stmts.hpp"
+#include "neo/ast/Type.hpp"
+#include "neo/base/Logger.hpp"
+#include "neo/base/Timer.hpp"
+#include "neo/compiler/CompileStats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
+namespace neo {
+
+    // header offsets, docs/neomodulefile.txt
+    static constexpr char kNmdMagic[4] {'N', 'M', 'D', 'F'};
+    static constexpr psize kHeaderSize = 48;
+    static constexpr psize kOffVersion = 4;
+    static constexpr psize kOffLittleEndian = 12;
+    static constexpr psize kOffMaps = 14;
+    enum MapIndex { kMetaMap, kImportMap, kTypeMap, kFuncMap, kEndMap, kMapCount };
+
+    static constexpr bool kLittleEndian = std::endian::native == std::endian::little;
+
+
+    static std::string typeName(ASTTypeNode* type) {
+        if (type == nullptr) {
+            return {};
+        }
+        std::string name {type->typeStr.str()};
+        if (type->getType() == kTypePointer) {
+            name += '*';
+        }
+        else if (type->getType() == kTypeArray) {
+            name += '[';
+            auto& size = ((ASTArrayType*)type)->size;
+            for (psize i = 0; i < size.size(); i++) {
+                name += (i != 0 ? "," : "") + std::to_string(size[i]);
+            }
+            name += ']';
+        }
+        return name;
+    }
+
+    static u32 declFlags(ASTDecl* d) {
+        return d->modifier.pack() | (d->isMarkedExport ? (u32)kNmdExport : 0u);
+    }
+
+    static std::string qualify(const std::string& prefix, std::string_view name) {
+        return prefix.empty() ? std::string {name} : prefix + "." + std::string {name};
+    }
+
+
+    /// gathers the declarations an importer can see, nested names are dot qualified
+    class ModuleCollector
+    {
+    public:
+        explicit ModuleCollector(NModuleInfo& out)
+            : m_out {out}
+        {}
+
+        void collect(ASTNode* n, const std::string& prefix) {
+            if (n == nullptr) {
+                return;
+            }
+            if (n->getType() == kStatment) {
+                if (((ASTStmt*)n)->getStmtKind() == StmtKind::kImport) {
+                    m_out.imports.emplace_back(((ImportStmt*)n)->moduleName.str());
+                }
+                return;
+            }
+            if (n->getType() != kDeclaration) {
+                return;
+            }
+
+            switch (((ASTDecl*)n)->getDeclKind()) {
+            case DeclKind::kModule: {
+                auto* d = (ModuleDecl*)n;
+                // the first top level `module x;` names the file's module, the rest of the file
+                // is its children and is named relative to it
+                if (prefix.empty() && m_out.name.empty()) {
+                    m_out.name = d->name.str();
+                    collect(d->children, prefix);
+                    break;
+                }
+                collect(d->children, qualify(prefix, d->name.str()));
+                break;
+            }
+            case DeclKind::kTopLevelDecls:
+                for (auto* decl : ((TopLevelDecls*)n)->decls) {
+                    collect(decl, prefix);
+                }
+                break;
+            case DeclKind::kFunc:
+                addFunc((FuncDecl*)n, prefix);
+                break;
+            case DeclKind::kClass: {
+                auto* d = (ClassDecl*)n;
+                std::string name = qualify(prefix, d->name.str());
+                auto& t = addType(d, name);
+                addMembers(t, d->fields);
+                addMembers(t, d->variables);
+                for (auto* f : d->functions) {
+                    addFunc(f, name);
+                }
+                for (auto* f : d->ctors) {
+                    addFunc(f, name);
+                }
+                if (d->dtors != nullptr) {
+                    addFunc(d->dtors, name);
+                }
+                for (auto* sub : d->subDataTypes) {
+                    collect(sub, name);
+                }
+                break;
+            }
+            case DeclKind::kStruct: {
+                auto* d = (StructDecl*)n;
+                auto& t = addType(d, qualify(prefix, d->name.str()));
+                addMembers(t, d->fields);
+                addMembers(t, d->variables);
+                break;
+            }
+            case DeclKind::kInterface: {
+                auto* d = (InterfaceDecl*)n;
+                std::string name = qualify(prefix, d->name.str());
+                addType(d, name);
+                for (auto* f : d->children) {
+                    addFunc(f, name);
+                }
+                break;
+            }
+            case DeclKind::kEnum: {
+                auto* d = (EnumDecl*)n;
+                auto& t = addType(d, qualify(prefix, d->name.str()));
+                std::string base = typeName(d->baseType);
+                for (auto* v : d->children) {
+                    t.members.push_back({std::string {v->name.str()}, base});
+                }
+                break;
+            }
+            default:
+                // module level variables have no map yet
+                break;
+            }
+        }
+
+    private:
+        NModuleInfo::Type& addType(ASTDecl* d, std::string name) {
+            m_out.types.push_back({std::move(name), (u32)d->getDeclKind(), declFlags(d), {}});
+            return m_out.types.back();
+        }
+
+        template <typename T>
+        void addMembers(NModuleInfo::Type& t, const ASTList<T*>& decls) {
+            for (auto* d : decls) {
+                t.members.push_back({std::string {d->name.str()}, typeName(d->type)});
+            }
+        }
+
+        void addFunc(FuncDecl* d, const std::string& prefix) {
+            NModuleInfo::Func f {qualify(prefix, d->name.str()), typeName(d->returnType), declFlags(d), {}};
+            for (auto* arg : d->args) {
+                f.params.push_back({std::string {arg->name.str()}, typeName(arg->type)});
+            }
+            m_out.funcs.push_back(std::move(f));
+        }
+
+    private:
+        NModuleInfo& m_out;
+    };
+
+
+    NModuleInfo NModuleInfo::fromNodes(const std::vector<ASTNode*>& nodes)
+    {
+        NModuleInfo info {};
+        ModuleCollector collector {info};
+        for (auto* n : nodes) {
+            collector.collect(n, {});
+        }
+        return info;
+    }
+
+
+    /// deduplicated text for the end map
+    class StringPool
+    {
+    public:
+        NmdString add(std::string_view str) {
+            auto it = m_index.find(str);
+            if (it != m_index.end()) {
+                return it->second;
+            }
+            NmdString s {(u32)m_data.size(), (u32)str.size()};
+            m_data.append(str);
+            m_index.emplace(str, s);
+            return s;
+        }
+
+        const std::string& data() const {
+            return m_data;
+        }
+
+    private:
+        // keys view the NModuleInfo being written, it outlives the pool
+        std::unordered_map<std::string_view, NmdString> m_index;
+        std::string m_data;
+    };
+
+
+    template <typename T>
+    static std::vector<const T*> sortedByName(const std::vector<T>& items) {
+        std::vector<const T*> sorted {};
+        sorted.reserve(items.size());
+        for (auto& item : items) {
+            sorted.push_back(&item);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const T* a, const T* b) { return a->name < b->name; });
+        return sorted;
+    }
+
+    template <typename T>
+    static void writeRecords(NMemorySerializer& out, const std::vector<T>& records) {
+        if (!records.empty()) {
+            out.write((void*)records.data(), records.size() * sizeof(T));
+        }
+    }
+
+
+    void NModuleWriter::build(NMemorySerializer& out, const NModuleInfo& info)
+    {
+        StringPool strings {};
+        u32 maps[kMapCount] {};
+
+        // the header is filled in last, once the map offsets are known
+        static constexpr char s_emptyHeader[kHeaderSize] {};
+        out.clear();
+        out.setMode(SerialMode::kFixed);
+        out.write((void*)s_emptyHeader, kHeaderSize);
+
+        maps[kMetaMap] = (u32)out.getPos();
+        NmdMeta meta {strings.add(info.name), strings.add(NE_NEOC_VERSION), info.sourceHash};
+        out.write(&meta, sizeof(meta));
+
+        out.padTo(8);
+        maps[kImportMap] = (u32)out.getPos();
+        std::vector<NmdImport> imports {};
+        for (auto& name : info.imports) {
+            imports.push_back({strings.add(name)});
+        }
+        NmdMapHead importHead {(u32)imports.size(), 0};
+        out.write(&importHead, sizeof(importHead));
+        writeRecords(out, imports);
+
+        auto member = [&](const NModuleInfo::Member& m) {
+            return NmdMember {strings.add(m.name), strings.add(m.type)};
+        };
+
+        out.padTo(8);
+        maps[kTypeMap] = (u32)out.getPos();
+        std::vector<NmdType> types {};
+        std::vector<NmdMember> typeMembers {};
+        for (auto* t : sortedByName(info.types)) {
+            types.push_back({strings.add(t->name), t->kind, t->flags, (u32)typeMembers.size(), (u32)t->members.size()});
+            for (auto& m : t->members) {
+                typeMembers.push_back(member(m));
+            }
+        }
+        NmdMapHead typeHead {(u32)types.size(), (u32)typeMembers.size()};
+        out.write(&typeHead, sizeof(typeHead));
+        writeRecords(out, types);
+        writeRecords(out, typeMembers);
+
+        out.padTo(8);
+        maps[kFuncMap] = (u32)out.getPos();
+        std::vector<NmdFunc> funcs {};
+        std::vector<NmdMember> params {};
+        for (auto* f : sortedByName(info.funcs)) {
+            funcs.push_back({strings.add(f->name), strings.add(f->returnType), f->flags,
+                             (u32)params.size(), (u32)f->params.size(), 0});
+            for (auto& p : f->params) {
+                params.push_back(member(p));
+            }
+        }
+        NmdMapHead funcHead {(u32)funcs.size(), (u32)params.size()};
+        out.write(&funcHead, sizeof(funcHead));
+        writeRecords(out, funcs);
+        writeRecords(out, params);
+
+        // the end map holds the text every other map points into
+        out.padTo(8);
+        maps[kEndMap] = (u32)out.getPos();
+        NmdMapHead endHead {(u32)strings.data().size(), 0};
+        out.write(&endHead, sizeof(endHead));
+        if (!strings.data().empty()) {
+            out.write((void*)strings.data().data(), strings.data().size());
+        }
+        psize end = out.getPos();
+
+        out.setPos(0);
+        out.write((void*)kNmdMagic, sizeof(kNmdMagic));
+        out.write(kVersion);
+        out.write(kVmMinVersion);
+        out.write(kLittleEndian);
+        out.setPos(kOffMaps);
+        for (u32 offset : maps) {
+            out.write(offset);
+        }
+        out.setPos(end);
+    }
+
+
+    bool NModuleWriter::write(const char* path, const NModuleInfo& info)
+    {
+        NTimer t {};
+        NMemorySerializer out {};
+        build(out, info);
+        if (!out.flush(path)) {
+            return false;
+        }
+        t.end();
+        NCompileStats::countWrite(out.size(), t.nanoTime());
+        return true;
+    }
+
+
+    bool NModuleFile::open(const char* path)
+    {
+        m_meta = nullptr;
+        if (!m_file.open(path) || m_file.size() < kHeaderSize) {
+            return false;
+        }
+
+        const char* base = m_file.data();
+        psize size = m_file.size();
+        auto u32At = [&](psize offset) {
+            u32 v = 0;
+            std::memcpy(&v, base + offset, sizeof(v));
+            return v;
+        };
+
+        if (std::memcmp(base, kNmdMagic, sizeof(kNmdMagic)) != 0
+            || u32At(kOffVersion) != NModuleWriter::kVersion
+            || (base[kOffLittleEndian] != 0) != kLittleEndian) {
+            LogError("{} is not a module file of this compiler", path);
+            return false;
+        }
+
+        u32 maps[kMapCount] {};
+        for (u32 i = 0; i < kMapCount; i++) {
+            maps[i] = u32At(kOffMaps + i * sizeof(u32));
+            bool ordered = i == 0 ? maps[i] >= kHeaderSize : maps[i] >= maps[i - 1];
+            if (!ordered || maps[i] % 8 != 0 || maps[i] + sizeof(NmdMapHead) > size) {
+                LogError("Module file {} is damaged", path);
+                return false;
+            }
+        }
+
+        // every map is bounded by the start of the next one, the end map by the file size
+        bool valid = maps[kMetaMap] + sizeof(NmdMeta) <= maps[kImportMap];
+        auto mapAt = [&](u32 map, auto& records, auto& members) {
+            psize limit = map + 1 < kMapCount ? maps[map + 1] : size;
+            NmdMapHead head {};
+            std::memcpy(&head, base + maps[map], sizeof(head));
+            using R = typename std::decay_t<decltype(records)>::value_type;
+            using M = typename std::decay_t<decltype(members)>::value_type;
+            psize first = maps[map] + sizeof(NmdMapHead);
+            psize second = first + (psize)head.count * sizeof(R);
+            if (second + (psize)head.memberCount * sizeof(M) > limit) {
+                valid = false;
+                return;
+            }
+            records = {(const R*)(base + first), head.count};
+            members = {(const M*)(base + second), head.memberCount};
+        };
+        std::span<const NmdMember> noMembers {};
+        mapAt(kImportMap, m_imports, noMembers);
+        mapAt(kTypeMap, m_types, m_typeMembers);
+        mapAt(kFuncMap, m_funcs, m_funcParams);
+        std::span<const char> strings {};
+        mapAt(kEndMap, strings, noMembers);
+        if (!valid) {
+            LogError("Module file {} is damaged", path);
+            return false;
+        }
+
+        m_meta = (const NmdMeta*)(base + maps[kMetaMap]);
+        m_strings = strings.data();
+        m_stringsSize = (u32)strings.size();
+        return true;
+    }
+
+
+    template <typename R>
+    static const R* findByName(const NModuleFile& file, std::span<const R> records, std::string_view name) {
+        auto it = std::lower_bound(records.begin(), records.end(), name, [&](const R& r, std::string_view key) {
+            return file.str(r.name) < key;
+        });
+        return it != records.end() && file.str(it->name) == name ? &*it : nullptr;
+    }
+
+    const NmdType* NModuleFile::findType(std::string_view name) const {
+        return findByName(*this, m_types, name);
+    }
+
+    const NmdFunc* NModuleFile::findFunc(std::string_view name) const {
+        return findByName(*this, m_funcs, name);
+    }
+}
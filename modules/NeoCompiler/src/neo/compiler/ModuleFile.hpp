@@ -0,0 +1,142 @@
+#pragma once
+
+#include "neo/common.hpp"
+#include "neo/base/Serializer.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neo {
+
+    class ASTNode;
+
+    /// Exported interface of one module, what an importer needs without the source
+    struct NModuleInfo
+    {
+        struct Member {
+            std::string name;
+            std::string type;
+        };
+        struct Type {
+            std::string name;       // qualified by the enclosing module blocks
+            u32 kind = 0;           // DeclKind
+            u32 flags = 0;          // NmdFlag bits
+            std::vector<Member> members;
+        };
+        struct Func {
+            std::string name;       // qualified by the enclosing module blocks and types
+            std::string returnType;
+            u32 flags = 0;
+            std::vector<Member> params;
+        };
+
+        /// collect the declarations of a parsed file, the module name is the first `module x;`
+        static NModuleInfo fromNodes(const std::vector<ASTNode*>& nodes);
+
+        std::string name;
+        u64 sourceHash = 0;
+        std::vector<std::string> imports;
+        std::vector<Type> types;
+        std::vector<Func> funcs;
+    };
+
+
+    // On-disk records, see docs/neomodulefile.txt. Sections start 8 byte aligned
+    // so the records can be used straight from a mapping.
+
+    enum NmdFlag : u32 {
+        kNmdModifierMask = 0x7f,    // ASTModifier::pack
+        kNmdExport = 1u << 7
+    };
+
+    /// text in the end map, offset relative to the start of the string data
+    struct NmdString { u32 offset; u32 size; };
+    struct NmdMeta { NmdString name; NmdString compiler; u64 sourceHash; };
+    struct NmdImport { NmdString name; };
+    struct NmdMember { NmdString name; NmdString type; };
+    struct NmdType { NmdString name; u32 kind; u32 flags; u32 firstMember; u32 memberCount; };
+    struct NmdFunc { NmdString name; NmdString returnType; u32 flags; u32 firstParam; u32 paramCount; u32 pad; };
+    /// leads the import, type and func maps, records follow sorted by name, then members
+    struct NmdMapHead { u32 count; u32 memberCount; };
+
+
+    /// .nmd writer
+    class NModuleWriter final
+    {
+    public:
+        /// format version, bump on any change to the records or the header
+        static constexpr u32 kVersion = 1;
+        /// oldest NeoVM able to load what this compiler writes
+        static constexpr u32 kVmMinVersion = 1;
+
+        static bool write(const char* path, const NModuleInfo& info);
+        /// the whole file image, write() flushes it in one call
+        static void build(NMemorySerializer& out, const NModuleInfo& info);
+    };
+
+
+    /// .nmd reader over a mapped file. Opening validates the header only,
+    /// lookups binary search the mapped maps and touch nothing else.
+    class NModuleFile final
+    {
+    public:
+        bool open(const char* path);
+
+        /// empty when s points outside the string data
+        std::string_view str(NmdString s) const {
+            if (s.offset > m_stringsSize || s.size > m_stringsSize - s.offset) {
+                return {};
+            }
+            return { m_strings + s.offset, s.size };
+        }
+        std::string_view name() const {
+            return str(m_meta->name);
+        }
+        u64 sourceHash() const {
+            return m_meta->sourceHash;
+        }
+
+        std::span<const NmdImport> imports() const {
+            return m_imports;
+        }
+        std::span<const NmdType> types() const {
+            return m_types;
+        }
+        std::span<const NmdFunc> funcs() const {
+            return m_funcs;
+        }
+
+        /// nullptr when the module has no such type / function
+        const NmdType* findType(std::string_view name) const;
+        const NmdFunc* findFunc(std::string_view name) const;
+
+        std::span<const NmdMember> members(const NmdType& t) const {
+            return slice(m_typeMembers, t.firstMember, t.memberCount);
+        }
+        std::span<const NmdMember> params(const NmdFunc& f) const {
+            return slice(m_funcParams, f.firstParam, f.paramCount);
+        }
+
+    private:
+        // records are checked when they are used, not all of them up front
+        static std::span<const NmdMember> slice(std::span<const NmdMember> all, u32 first, u32 count) {
+            if (first > all.size() || count > all.size() - first) {
+                return {};
+            }
+            return all.subspan(first, count);
+        }
+
+    private:
+        NMappedSerializer m_file;
+        const NmdMeta* m_meta = nullptr;
+        const char* m_strings = nullptr;
+        u32 m_stringsSize = 0;
+        std::span<const NmdImport> m_imports;
+        std::span<const NmdType> m_types;
+        std::span<const NmdMember> m_typeMembers;
+        std::span<const NmdFunc> m_funcs;
+        std::span<const NmdMember> m_funcParams;
+    };
+}
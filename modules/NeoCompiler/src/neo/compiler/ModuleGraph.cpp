@@ -0,0 +1,304 @@
+#include "ModuleGraph.hpp"
+
+#include "neo/base/Logger.hpp"
+#include "neo/base/ThreadPool.hpp"
+#include "neo/compiler/LexScan.hpp"
+#include "neo/compiler/LexTables.hpp"
+#include "neo/base/SourceBuffer.hpp"
+#include "neo/compiler/SourceDir.hpp"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <unordered_map>
+
+namespace neo {
+
+    static constexpr u32 kNoComponent = std::numeric_limits<u32>::max();
+
+    NE_FORCE_INLINE static bool hasFlag(char c, u8 flag) {
+        return (kCharTable.flags[(u8)c] & flag) != 0;
+    }
+
+    static const char* skipWord(const char* p, const char* end) {
+        while (p < end && hasFlag(*p, kCharIdBody)) {
+            p++;
+        }
+        return p;
+    }
+
+    /// dotted name after `import` / `module`, like the parser it takes identifiers and dots
+    static const char* readName(const char* p, const char* end, std::string& out) {
+        while (true) {
+            p = scan::skipSpaces(p, end);
+            if (p >= end) {
+                return p;
+            }
+            if (*p == '.') {
+                out.push_back('.');
+                p++;
+            } else if (hasFlag(*p, kCharIdStart)) {
+                const char* word = p;
+                p = skipWord(p, end);
+                out.append(word, p);
+            } else {
+                return p;
+            }
+        }
+    }
+
+
+    NModuleScan NModuleScan::fromText(std::string_view text)
+    {
+        NModuleScan scan {};
+        const char* p = text.data();
+        const char* end = p + text.size();
+        u32 depth = 0;
+        bool named = false;
+
+        // only comments, literals and braces need care, everything else is skipped a byte or a word at a time
+        while (true) {
+            p = scan::skipSpaces(p, end);
+            if (p >= end) {
+                break;
+            }
+
+            char c = *p;
+            if (c == '/' && p + 1 < end && p[1] == '/') {
+                p = scan::findLineEnd(p + 2, end);
+            } else if (c == '/' && p + 1 < end && p[1] == '*') {
+                p = scan::findBlockCommentEnd(p + 2, end);
+                p = end - p < 2 ? end : p + 2;
+            } else if (c == '\"') {
+                p++;
+                while (true) {
+                    p = scan::findStringStop(p, end);
+                    if (p < end && *p == '\\') {
+                        p = std::min(p + 2, end);
+                        continue;
+                    }
+                    if (p < end && *p == '\"') {
+                        p++;
+                    }
+                    break;
+                }
+            } else if (c == '\'') {
+                p++;
+                while (p < end && *p != '\'' && *p != '\n') {
+                    p += *p == '\\' ? 2 : 1;
+                }
+                p = std::min(p + 1, end);
+            } else if (c == '{') {
+                depth++;
+                p++;
+            } else if (c == '}') {
+                depth -= depth > 0 ? 1 : 0;
+                p++;
+            } else if (hasFlag(c, kCharIdStart)) {
+                const char* word = p;
+                p = skipWord(p, end);
+                std::string_view id {word, (psize)(p - word)};
+                if (id == "import") {
+                    std::string name {};
+                    p = readName(p, end, name);
+                    if (!name.empty()) {
+                        scan.imports.push_back(std::move(name));
+                    }
+                } else if (id == "module" && depth == 0 && !named) {
+                    p = readName(p, end, scan.module);
+                    named = true;
+                }
+            } else if (hasFlag(c, kCharDigit)) {
+                // keeps suffixes like the e in 1e5 from starting a word
+                p = skipWord(p, end);
+            } else {
+                p++;
+            }
+        }
+        return scan;
+    }
+
+
+    bool NModuleScan::fromFile(const std::string& path, NModuleScan& out)
+    {
+        NSourceBuffer buffer {};
+        if (!buffer.loadFile(path)) {
+            return false;
+        }
+        out = fromText(buffer.view());
+        return true;
+    }
+
+
+    u32 NModuleGraph::add(NSourceDir& dir, psize idx, NModuleScan scan)
+    {
+        auto& unit = m_units.emplace_back();
+        unit.dir = &dir;
+        unit.idx = idx;
+        unit.scan = std::move(scan);
+        return (u32)m_units.size() - 1;
+    }
+
+
+    std::string_view NModuleGraph::pathOf(u32 unit) const
+    {
+        auto& u = m_units[unit];
+        return u.dir->getSource(u.idx).getRelativePath();
+    }
+
+
+    bool NModuleGraph::link()
+    {
+        // a module may be spread over several files, importers wait for all of them
+        std::unordered_map<std::string_view, std::vector<u32>> declared {};
+        for (u32 i = 0; i < m_units.size(); i++) {
+            if (!m_units[i].scan.module.empty()) {
+                declared[m_units[i].scan.module].push_back(i);
+            }
+        }
+
+        for (u32 i = 0; i < m_units.size(); i++) {
+            auto& unit = m_units[i];
+            unit.deps.clear();
+            unit.dependents.clear();
+            for (auto& imp : unit.scan.imports) {
+                auto it = declared.find(imp);
+                if (it == declared.end() || imp == unit.scan.module) {
+                    continue;
+                }
+                unit.deps.insert(unit.deps.end(), it->second.begin(), it->second.end());
+            }
+            std::sort(unit.deps.begin(), unit.deps.end());
+            unit.deps.erase(std::unique(unit.deps.begin(), unit.deps.end()), unit.deps.end());
+        }
+
+        m_components.clear();
+        std::vector<u32> index(m_units.size(), kNoComponent);
+        std::vector<u32> low(m_units.size(), 0);
+        std::vector<u32> stack {};
+        std::vector<bool> onStack(m_units.size(), false);
+        u32 counter = 0;
+        for (u32 i = 0; i < m_units.size(); i++) {
+            if (index[i] == kNoComponent) {
+                strongConnect(i, index, low, stack, onStack, counter);
+            }
+        }
+
+        // report every cycle, then drop the edges inside it so its files are built in any order
+        std::vector<u32> componentOf(m_units.size(), kNoComponent);
+        for (u32 c = 0; c < m_components.size(); c++) {
+            for (u32 unit : m_components[c]) {
+                componentOf[unit] = c;
+            }
+        }
+        for (u32 c = 0; c < m_components.size(); c++) {
+            reportCycle(m_components[c], componentOf);
+        }
+        for (u32 i = 0; i < m_units.size(); i++) {
+            auto& deps = m_units[i].deps;
+            if (componentOf[i] != kNoComponent) {
+                std::erase_if(deps, [&](u32 d) { return componentOf[d] == componentOf[i]; });
+            }
+            for (u32 d : deps) {
+                m_units[d].dependents.push_back(i);
+            }
+        }
+        return m_components.empty();
+    }
+
+
+    void NModuleGraph::strongConnect(u32 unit, std::vector<u32>& index, std::vector<u32>& low,
+                                     std::vector<u32>& stack, std::vector<bool>& onStack, u32& counter)
+    {
+        index[unit] = low[unit] = counter++;
+        stack.push_back(unit);
+        onStack[unit] = true;
+
+        for (u32 d : m_units[unit].deps) {
+            if (index[d] == kNoComponent) {
+                strongConnect(d, index, low, stack, onStack, counter);
+                low[unit] = std::min(low[unit], low[d]);
+            } else if (onStack[d]) {
+                low[unit] = std::min(low[unit], index[d]);
+            }
+        }
+
+        if (low[unit] != index[unit]) {
+            return;
+        }
+        std::vector<u32> component {};
+        u32 member = 0;
+        do {
+            member = stack.back();
+            stack.pop_back();
+            onStack[member] = false;
+            component.push_back(member);
+        } while (member != unit);
+
+        // a single file can't import itself, its own module has no edge
+        if (component.size() > 1) {
+            std::sort(component.begin(), component.end());
+            m_components.push_back(std::move(component));
+        }
+    }
+
+
+    void NModuleGraph::reportCycle(const std::vector<u32>& component, const std::vector<u32>& componentOf)
+    {
+        // every file of a component imports another one of it, walking those edges must come back
+        u32 id = componentOf[component.front()];
+        std::vector<u32> path {};
+        std::vector<u32>::iterator first {};
+        u32 unit = component.front();
+        while ((first = std::find(path.begin(), path.end(), unit)) == path.end()) {
+            path.push_back(unit);
+            auto& deps = m_units[unit].deps;
+            unit = *std::find_if(deps.begin(), deps.end(), [&](u32 d) { return componentOf[d] == id; });
+        }
+
+        std::string chain {};
+        for (auto it = first; it != path.end(); it++) {
+            chain += std::format("{} ({}) -> ", m_units[*it].scan.module, pathOf(*it));
+        }
+        chain += m_units[unit].scan.module;
+        LogError("Import cycle : {}", chain);
+        if (component.size() > (psize)(path.end() - first)) {
+            LogError("{} files import each other in this cycle, the first is {}", component.size(), pathOf(component.front()));
+        }
+    }
+
+
+    void NModuleGraph::run(NThreadPool& pool, Task task)
+    {
+        m_task = std::move(task);
+        m_waiting = std::make_unique<std::atomic<u32>[]>(m_units.size());
+        for (u32 i = 0; i < m_units.size(); i++) {
+            m_waiting[i].store((u32)m_units[i].deps.size(), std::memory_order_relaxed);
+        }
+
+        // counters are all set before the first task may finish and touch them
+        for (u32 i = 0; i < m_units.size(); i++) {
+            if (m_units[i].deps.empty()) {
+                submit(pool, i);
+            }
+        }
+        pool.wait();
+        m_task = nullptr;
+    }
+
+
+    void NModuleGraph::submit(NThreadPool& pool, u32 unit)
+    {
+        pool.submit([this, &pool, unit] {
+            auto& u = m_units[unit];
+            m_task(*u.dir, u.idx);
+
+            // the last dependency to finish starts the dependent
+            for (u32 next : u.dependents) {
+                if (m_waiting[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    submit(pool, next);
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "neo/common.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neo {
+
+    class NSourceDir;
+    class NThreadPool;
+
+    /// Module name and imports of a source, all the scheduler needs to know before parsing
+    struct NModuleScan
+    {
+        /// the first top level `module x`, empty when the file declares none
+        std::string module;
+        std::vector<std::string> imports;
+
+        /// find `module` and `import` statements without lexing or parsing the file.
+        /// text must be followed by NSourceBuffer padding
+        static NModuleScan fromText(std::string_view text);
+        static bool fromFile(const std::string& path, NModuleScan& out);
+    };
+
+
+    /// Import graph of every source file in a build.
+    /// A file depends on the files declaring the modules it imports, imports of modules the
+    /// build has no source for add no edge. run() starts every file as soon as the files it
+    /// depends on finished, so the interfaces it imports are ready when it is built.
+    class NModuleGraph final
+    {
+    public:
+        using Task = std::function<void(NSourceDir& dir, psize idx)>;
+
+        /// add source idx of dir, returns the unit index
+        u32 add(NSourceDir& dir, psize idx, NModuleScan scan);
+
+        /// turn imports into edges and report import cycles, false when there is one.
+        /// Files in a cycle lose the edges inside it, so they are still built once
+        bool link();
+
+        /// run task once per unit on pool in dependency order, returns when all of them finished
+        void run(NThreadPool& pool, Task task);
+
+        u32 size() const {
+            return (u32)m_units.size();
+        }
+
+    private:
+        struct Unit {
+            NSourceDir* dir = nullptr;
+            psize idx = 0;
+            NModuleScan scan;
+            std::vector<u32> deps;
+            std::vector<u32> dependents;
+        };
+
+        // Tarjan, the components of more than one file go to m_components
+        void strongConnect(u32 unit, std::vector<u32>& index, std::vector<u32>& low,
+                           std::vector<u32>& stack, std::vector<bool>& onStack, u32& counter);
+        void reportCycle(const std::vector<u32>& component, const std::vector<u32>& componentOf);
+        std::string_view pathOf(u32 unit) const;
+        void submit(NThreadPool& pool, u32 unit);
+
+    private:
+        std::vector<Unit> m_units;
+        std::vector<std::vector<u32>> m_components;
+        // deps of a unit that did not finish yet
+        std::unique_ptr<std::atomic<u32>[]> m_waiting;
+        Task m_task;
+    };
+}
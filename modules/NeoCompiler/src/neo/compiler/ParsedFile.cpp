@@ -1,19 +1,218 @@
 #include "ParsedFile.hpp"
 
 #include "neo/ast/Base.hpp"
+#include "neo/ast/FlatAST.hpp"
+#include "neo/base/Hash.hpp"
+#include "neo/base/Logger.hpp"
+#include "neo/base/Serializer.hpp"
+#include "neo/base/Timer.hpp"
+#include "neo/compiler/CompileStats.hpp"
+#include "neo/base/SourceBuffer.hpp"
+
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
 
 namespace neo {
 
+    // .nast image, native endianness, every section 8 byte aligned:
+    //   NastHeader
+    //   NastArray[kArrayCount]       pools in FlatPoolTypes order, then refs, then ints
+    //   u32[symbolCount + 1]         symbol text offsets
+    //   char[]                       symbol text
+    //   array data
+    // payloadHash covers everything after the header.
+    struct NastHeader {
+        char magic[4];
+        u32 version;
+        u64 compilerKey;
+        u64 sourceHash;
+        u64 payloadHash;
+        u64 symbolsOffset;
+        u32 symbolCount;
+        u32 arrayCount;
+        FlatRange roots;
+    };
+
+    struct NastArray {
+        u64 offset;
+        u64 count;
+        u32 elemSize;
+        u32 pad;
+    };
+
+    static constexpr char kNastMagic[4] {'N', 'A', 'S', 'T'};
+    static constexpr u32 kArrayCount = std::tuple_size_v<FlatPoolTypes> + 2;
+
+    /// identifies the compiler build, a different release or host toolchain may lay the pools out differently
+    static u64 compilerKey() {
+        static const u64 s_key = hashBytes(NE_NEOC_VERSION "|" NE_COMPILER_STR "|" NE_STR);
+        return s_key;
+    }
+
+    static psize alignUp(psize v) {
+        return (v + 7) & ~(psize)7;
+    }
+
+
     NParsedFile::NParsedFile() {
 
     }
 
 
     void NParsedFile::clearNodes() {
-        for (auto* item : Nodes) {
-            delete item;
-        }
+        // nodes reference each other, only the arena may destroy them
         Nodes.clear();
+        m_arena.reset();
     }
-    
-} // namespace neo
\ No newline at end of file
+
+
+    bool NParsedFile::saveTo(const char* path, u64 sourceHash, NSourceFile* file)
+    {
+        NTimer t {};
+        NFlatAST flat = NFlatAST::fromNodes(Nodes, file);
+
+        // array offsets go in the table in front of the data, so lay the image out first
+        psize symbolsOffset = sizeof(NastHeader) + sizeof(NastArray) * kArrayCount;
+        psize textSize = 0;
+        for (NSymbol sym : flat.symbols) {
+            textSize += sym.str().size();
+        }
+        psize pos = alignUp(symbolsOffset + sizeof(u32) * (flat.symbols.size() + 1) + textSize);
+
+        NastArray arrays[kArrayCount] {};
+        u32 idx = 0;
+        flat.forEachArray([&](auto& items) {
+            arrays[idx] = {pos, items.size(), (u32)sizeof(items[0]), 0};
+            pos = alignUp(pos + items.size() * sizeof(items[0]));
+            idx++;
+        });
+
+        NMemorySerializer out {pos};
+        NastHeader header {};
+        out.write(&header, sizeof(header));
+        out.write(arrays, sizeof(arrays));
+
+        u32 textPos = 0;
+        for (NSymbol sym : flat.symbols) {
+            out.write((void*)&textPos, sizeof(textPos));
+            textPos += (u32)sym.str().size();
+        }
+        out.write((void*)&textPos, sizeof(textPos));
+        for (NSymbol sym : flat.symbols) {
+            std::string_view str = sym.str();
+            out.write((void*)str.data(), str.size());
+        }
+
+        flat.forEachArray([&](auto& items) {
+            out.padTo(8);
+            out.write((void*)items.data(), items.size() * sizeof(items[0]));
+        });
+        out.padTo(8);
+        NE_ASSERT(out.size() == pos);
+
+        std::memcpy(header.magic, kNastMagic, sizeof(kNastMagic));
+        header.version = kNastVersion;
+        header.compilerKey = compilerKey();
+        header.sourceHash = sourceHash;
+        header.payloadHash = hashBytes(out.data() + sizeof(NastHeader), out.size() - sizeof(NastHeader));
+        header.symbolsOffset = symbolsOffset;
+        header.symbolCount = (u32)flat.symbols.size();
+        header.arrayCount = kArrayCount;
+        header.roots = flat.roots;
+        out.setPos(0);
+        out.write(&header, sizeof(header));
+
+        // write next to the target and rename, a concurrent or later reader never sees half an image
+        std::string tmpPath = std::string {path} + ".tmp";
+        if (!out.flush(tmpPath.c_str())) {
+            return false;
+        }
+        std::error_code ec {};
+        fs::rename(tmpPath, path, ec);
+        if (ec) {
+            LogError("Failed to write ast cache {} : {}", path, ec.message());
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+        t.end();
+        NCompileStats::countWrite(out.size(), t.nanoTime());
+        return true;
+    }
+
+
+    bool NParsedFile::loadFrom(const char* path, u64 sourceHash, NSourceFile* file)
+    {
+        NTimer t {};
+        std::error_code ec {};
+        if (!fs::exists(path, ec)) {
+            return false;
+        }
+
+        // large images are mapped, the pools below are read in place
+        NSourceBuffer image {};
+        if (!image.loadFile(path) || image.size() < sizeof(NastHeader) + sizeof(NastArray) * kArrayCount) {
+            return false;
+        }
+        const char* base = image.data();
+
+        NastHeader header {};
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, kNastMagic, sizeof(kNastMagic)) != 0
+            || header.version != kNastVersion
+            || header.compilerKey != compilerKey()
+            || header.sourceHash != sourceHash
+            || header.arrayCount != kArrayCount) {
+            return false;
+        }
+        // the hash catches damaged or truncated images, refs inside the pools are trusted after it
+        if (header.payloadHash != hashBytes(base + sizeof(NastHeader), image.size() - sizeof(NastHeader))) {
+            LogDebug("Ast cache {} is damaged, ignored", path);
+            return false;
+        }
+
+        NFlatView view {};
+        auto* arrays = (const NastArray*)(base + sizeof(NastHeader));
+        u32 idx = 0;
+        bool valid = true;
+        auto bind = [&](auto& span) {
+            using T = typename std::decay_t<decltype(span)>::value_type;
+            const NastArray& a = arrays[idx++];
+            if (a.elemSize != sizeof(T) || a.offset % alignof(T) != 0 || a.offset + a.count * sizeof(T) > image.size()) {
+                valid = false;
+                return;
+            }
+            span = {(const T*)(base + a.offset), a.count};
+        };
+        std::apply([&](auto&... pools) { (bind(pools), ...); }, view.pools);
+        bind(view.refs);
+        bind(view.ints);
+        if (!valid) {
+            return false;
+        }
+
+        psize textBase = header.symbolsOffset + sizeof(u32) * (header.symbolCount + 1);
+        if (header.symbolsOffset % alignof(u32) != 0 || textBase > image.size()) {
+            return false;
+        }
+        auto* offsets = (const u32*)(base + header.symbolsOffset);
+        if (textBase + offsets[header.symbolCount] > image.size()) {
+            return false;
+        }
+        std::vector<NSymbol> symbols {};
+        symbols.reserve(header.symbolCount);
+        for (u32 i = 0; i < header.symbolCount; i++) {
+            symbols.push_back(intern({base + textBase + offsets[i], offsets[i + 1] - offsets[i]}));
+        }
+        view.symbols = symbols;
+        view.roots = header.roots;
+
+        clearNodes();
+        view.toNodes(m_arena, Nodes, file);
+        t.end();
+        NCompileStats::countRead(image.size(), t.nanoTime());
+        return true;
+    }
+
+} // namespace neo
@@ -1,23 +1,40 @@
 #pragma once
 
+#include "neo/base/Arena.hpp"
+
 #include <vector>
 
 namespace neo {
 
-    class ASTNode;\
+    class ASTNode;
+
+    /// Parse result of one source file, the arena owns every node and child array
     class NParsedFile 
     {
     public:
+        /// .nast image layout version, bump on any change to the flat pools or the header
+        static constexpr u32 kNastVersion = 1;
+
         NParsedFile();
         ~NParsedFile() = default;
 
         void debugOutput(class NDebugOutput&);
-        void saveTo(const char* path);
-        bool loadFrom(const char* path);
+        /// write the nodes as a .nast image keyed by the hash of the source they were parsed from
+        bool saveTo(const char* path, u64 sourceHash, class NSourceFile* file);
+        /// replace the nodes with a .nast image, false if it is missing, damaged,
+        /// or was written for other source content or another compiler build
+        bool loadFrom(const char* path, u64 sourceHash, class NSourceFile* file);
 
         void clearNodes();
 
+        NArena& getArena() {
+            return m_arena;
+        }
+
     public:
         std::vector<ASTNode*> Nodes;
+
+    private:
+        NArena m_arena;
     };
-}
\ No newline at end of file
+}
@@ -19,30 +19,6 @@
 
 namespace neo {
 
-    template <typename T>
-    struct ScopeGuard
-    {
-        ScopeGuard(T* ptr) : m_ptr{ ptr }, m_used{ false } {}
-        ~ScopeGuard() {
-            if (m_used) return;
-            delete m_ptr;
-        }
-
-        T* getPtr() {
-            m_used = true;
-            return m_ptr;
-        }
-
-        T* operator->() {
-            return m_ptr;
-        }
-
-    private:
-        bool m_used;
-        T* m_ptr;
-    };
-
-
     TokenType NParser::s_modifier[] = {
         TokenType::kInline,
         TokenType::kStatic,
@@ -55,13 +31,6 @@ namespace neo {
 
 #define CHECK_MODIFIER(ITEM, ITEM_NAME) if (ITEM) { return Result::failure("duplicated modifier "#ITEM_NAME); }
 #define ERRR() &m_diag, current(), m_args.file
-#define CLEARUP(V) \
-do { \
-    for (auto* ptr : V) { \
-        delete ptr; \
-    } \
-    V.clear();\
-} while(false) \
 
     NParser::NParser(NParserArgs args)
         : m_args{ args }
@@ -74,24 +43,30 @@ do { \
         m_diag.clear();
     }
 
-    NToken& NParser::advance() {
+    NToken NParser::advance() {
         return m_lexer->nextToken();
     }
-    NToken& NParser::current() {
+    NToken NParser::current() {
         return m_lexer->current();
     }
-    NToken& NParser::peek() {
+    NToken NParser::peek() {
         return m_lexer->peekNext();
     }
-    NToken& NParser::peekPrevious() {
+    NToken NParser::peekPrevious() {
         return m_lexer->peekPrevious();
     }
-    NToken& NParser::previous() {
+    NToken NParser::previous() {
         return m_lexer->previousToken();
     }
+    std::string_view NParser::text(const NToken& tk) {
+        return m_lexer->tokenText(tk);
+    }
+    NSymbol NParser::symbol(const NToken& tk) {
+        return intern(m_lexer->tokenText(tk));
+    }
     bool NParser::match(TokenType type)
     {
-        return current().type == type;
+        return m_lexer->currentType() == type;
     }
     bool NParser::expect(TokenType type)
     {
@@ -99,7 +74,7 @@ do { \
     }
     bool NParser::check(TokenType type)
     {
-        return m_lexer->current().type == type;
+        return m_lexer->currentType() == type;
     }
 
     // top-statement parser
@@ -144,7 +119,7 @@ do { \
         do {
             advance();
             if (check(TokenType::kIdentifier)) {
-                moduleName.append(current().value);
+                moduleName.append(text(current()));
             }
             else if (check(TokenType::kDot)) {
                 moduleName.append(".");
@@ -159,7 +134,7 @@ do { \
             }
         } while (true);
 
-        return new ImportStmt(moduleName);
+        return make<ImportStmt>(intern(moduleName));
     }
 
     // module declare parser
@@ -178,7 +153,7 @@ do { \
         do {
             advance();
             if (check(TokenType::kIdentifier)) {
-                module.append(current().value);
+                module.append(text(current()));
             }
             else if (check(TokenType::kDot)) {
                 module.append(".");
@@ -190,13 +165,13 @@ do { \
                 return Result::failure(msg("unexpected token '", current().typeString(), "' for module declare"), ERRR());
             }
         } while (true);
-        auto gd = ScopeGuard(new ModuleDecl(module));
+        auto gd = make<ModuleDecl>(intern(module));
 
         if (check(TokenType::kSemicolon)) {
             // top level module decl
             // trigger decl parsing logic and make those decls as module's children
 
-            gd->children = new TopLevelDecls();
+            gd->children = make<TopLevelDecls>();
             do {
                 advance();
                 if (check(TokenType::kEOF)) {
@@ -222,7 +197,7 @@ do { \
             return Result::failure(msg("expect ';' or '{' behind module declare statement, but found '", current().typeString(), "'"), ERRR());
         }
 
-        return gd.getPtr();
+        return gd;
     }
 
     // function declaration parser
@@ -231,15 +206,15 @@ do { \
     Expected<FuncDecl*> NParser::parseFunc()
     {
         if (!check(TokenType::kFun) && expect(TokenType::kIdentifier)) {
-            return Result::failure(msg("unexpected token for function declare : ", current().value, " ", peek().value), ERRR());
+            return Result::failure(msg("unexpected token for function declare : ", text(current()), " ", text(peek())), ERRR());
         }
         advance();
 
         // function name parsing logic
-        std::string name = current().value;
+        NSymbol name = symbol(current());
 
         if (!expect(TokenType::kLParen)) {
-            return Result::failure(msg("function declare expect '(' for function arguments but got '", peek().value, "'"), ERRR());
+            return Result::failure(msg("function declare expect '(' for function arguments but got '", text(peek()), "'"), ERRR());
         }
         advance();
 
@@ -259,18 +234,18 @@ do { \
         if (check(TokenType::kSemicolon)) {
             // end with ';' just return
 
-            return new FuncDecl(name, returnType, args.value(), nullptr);
+            return make<FuncDecl>(name, returnType, std::move(args.value()), nullptr);
         }
         else if (check(TokenType::kLBraces)) {
             // end with '{'
 
-            std::vector<ASTStmt*> bodyStmts {};
+            ASTList<ASTStmt*> bodyStmts {};
             do {
                 advance();
                 if (check(TokenType::kVar) || check(TokenType::kVal)) {
                     auto r = parseVarDecl();
                     CHECK_ERROR(r);
-                    bodyStmts.push_back(new DeclStmt(r.value()));
+                    bodyStmts.push_back(make<DeclStmt>(r.value()));
                 } else if (check(TokenType::kRBraces)) {
                     advance();
                     break;
@@ -281,7 +256,7 @@ do { \
                 }
             } while(true);
 
-            return new FuncDecl(name, returnType, args.value(), new CompoundStmt(std::move(bodyStmts)));
+            return make<FuncDecl>(name, returnType, std::move(args.value()), make<CompoundStmt>(std::move(bodyStmts)));
         } else {
             return Result::failure("unexpected token after function head", ERRR());
         }
@@ -297,30 +272,34 @@ do { \
         }
 
         // get full type string including module and type
-        std::string typeStr;
-        typeStr.append(current().value);
+        NSymbol typeStr = symbol(current());
         advance();
 
-        while (check(TokenType::kDot)) {
-            advance(); // eat dot
+        if (check(TokenType::kDot)) {
+            // qualified name, only these need the joined string built
+            std::string qualified {typeStr.str()};
+            while (check(TokenType::kDot)) {
+                advance(); // eat dot
 
-            if (!check(TokenType::kIdentifier)) {
-                return Result::failure("expected identifier after '.' in type name", ERRR());
-            }
+                if (!check(TokenType::kIdentifier)) {
+                    return Result::failure("expected identifier after '.' in type name", ERRR());
+                }
 
-            typeStr.append(".");
-            typeStr.append(current().value);
-            advance();
+                qualified.append(".");
+                qualified.append(text(current()));
+                advance();
+            }
+            typeStr = intern(qualified);
         }
 
         if (check(TokenType::kLBracket)) {
             // parse array type's bracket and check array dimenssion
 
             advance(); // eat left bracket '['
-            ScopeGuard<ASTArrayType> gd {new ASTArrayType(std::move(typeStr), false, {})};
+            auto* gd = make<ASTArrayType>(typeStr, false, std::initializer_list<int> {});
             do {
                 if (check(TokenType::kIntLit)) {
-                    gd->size.push_back(std::stoi(current().value));
+                    gd->size.push_back(std::stoi(std::string{ text(current()) }));
                     advance();
                     continue;
                 } else if (check(TokenType::kComma)) {
@@ -337,17 +316,17 @@ do { \
             if (gd->size.empty()) {
                 gd->isReceiver = true;
             }
-            return gd.getPtr();
+            return gd;
 
         } else if (check(TokenType::kMul)) {
             // parse pointer type
 
             advance();
-            return new ASTPointerType(std::move(typeStr));
+            return make<ASTPointerType>(typeStr);
         } else {
             // normal type just return
 
-            return new ASTTypeNode(std::move(typeStr));
+            return make<ASTTypeNode>(typeStr);
         }
     }
 
@@ -355,9 +334,9 @@ do { \
 
     // fuction calling expression's argument list parser
     // syntax like xxx(aa,bb,cc,...)
-    Expected<std::vector<ASTExpr*>> NParser::parseFuncCallArgs()
+    Expected<ASTList<ASTExpr*>> NParser::parseFuncCallArgs()
     {
-        std::vector<ASTExpr*> args{};
+        ASTList<ASTExpr*> args{};
         if (!check(TokenType::kLParen)) {
             return args;
         }
@@ -381,10 +360,10 @@ do { \
 
     // function's argument parser
     // syntax like (xx : xx, xx : xx = xx, ...)
-    Expected<std::vector<VarDecl *>> NParser::parseFuncArgs() {
+    Expected<ASTList<VarDecl*>> NParser::parseFuncArgs() {
         // function argument parsing logic
-        std::vector<VarDecl*> args{};
-        std::vector<Attribute*> attrs{};
+        ASTList<VarDecl*> args{};
+        AttributeList attrs{};
 
         advance(); // eat left paren '('
         do {
@@ -400,11 +379,11 @@ do { \
                 CHECK_ERROR(r);
                 auto md = r.value();
 
-                std::string& arg_name = current().value;
+                NSymbol arg_name = symbol(current());
                 advance();
                 if (!expect(TokenType::kIdentifier)) {
                     advance();
-                    return Result::failure(msg("expect type identifier for function argument, but receive '", current().value, "'"), ERRR());
+                    return Result::failure(msg("expect type identifier for function argument, but receive '", text(current()), "'"), ERRR());
                 }
                 advance();
                 auto t = parseType();
@@ -414,17 +393,17 @@ do { \
                     advance();
                     auto epr = parseExpr();
                     CHECK_ERROR(epr);
-                    args.push_back(new VarDecl(arg_name, t.value(), epr.value()));
+                    args.push_back(make<VarDecl>(arg_name, t.value(), epr.value()));
                     args.back()->attributes = std::move(attrs);
                     args.back()->modifier = std::move(md);
-                    attrs = std::vector<Attribute*>{};
+                    attrs = AttributeList{};
 
                     continue;
                 } else if (check(TokenType::kComma) || check(TokenType::kRParen)) {
-                    args.push_back(new VarDecl(arg_name, t.value()));
+                    args.push_back(make<VarDecl>(arg_name, t.value()));
                     args.back()->attributes = std::move(attrs);
                     args.back()->modifier = std::move(md);
-                    attrs = std::vector<Attribute*>{};
+                    attrs = AttributeList{};
 
                     // only break when meet ')'
                     if (check(TokenType::kRParen)) {
@@ -462,7 +441,7 @@ do { \
         advance();
 
         // parse content logic
-        auto gd = ScopeGuard(new TopLevelDecls());
+        auto gd = make<TopLevelDecls>();
         do {
             if (check(TokenType::kRBraces)) {
                 advance();
@@ -474,7 +453,7 @@ do { \
             }
         } while(true);
 
-        return gd.getPtr();
+        return gd;
     }
 
     // modifier parser
@@ -525,9 +504,9 @@ do { \
 
     // parse attributes on decls
     // syntax like [xxx(...)] or [xxx]
-    Expected<std::vector<Attribute*>> NParser::parseAttributes()
+    Expected<AttributeList> NParser::parseAttributes()
     {
-        std::vector<Attribute*> attrs{};
+        AttributeList attrs{};
 
         do {
             // check '[xxx'
@@ -537,8 +516,8 @@ do { \
             advance();
 
             // get attribute's string-lit
-            std::string name = current().value;
-            ScopeGuard g{ new Attribute {} };
+            NSymbol name = symbol(current());
+            auto* g = make<Attribute>();
             g->name = name;
 
             // check '[xxx(' <- and parse args
@@ -554,17 +533,15 @@ do { \
                 CHECK_ERROR(r);
                 g->arguments.swap(r.value());
                 if (!expect(TokenType::kRBracket)) {
-                    CLEARUP(attrs);
-                    return Result::failure(msg("expect ']' to close attribute attach but got '", current().value, "'"), ERRR());
+                    return Result::failure(msg("expect ']' to close attribute attach but got '", text(current()), "'"), ERRR());
                 }
-                attrs.push_back(g.getPtr());
+                attrs.push_back(g);
             }
             else if (check(TokenType::kRBracket)) {
-                attrs.push_back(g.getPtr());
+                attrs.push_back(g);
             }
             else {
-                CLEARUP(attrs);
-                return Result::failure(msg("unexpect token '", current().value, "' after attribute attach's name"), ERRR());
+                return Result::failure(msg("unexpect token '", text(current()), "' after attribute attach's name"), ERRR());
             }
         } while (expect(TokenType::kLBracket));
 
@@ -577,7 +554,7 @@ do { \
     {
         auto md = parseModifier();
         CHECK_ERROR(md);
-        std::vector<Attribute*> attrs {};
+        AttributeList attrs {};
 
         if (check(TokenType::kLBracket)) {
             // parse attribute
@@ -667,14 +644,14 @@ do { \
         if (!check(TokenType::kIdentifier)) {
             return Result::failure(msg("expected identifier for class name but got : '", current().typeString(), "'"), ERRR());
         }
-        std::string name = current().value;
+        NSymbol name = symbol(current());
 
         // super classes parsing
-        std::vector<ASTTypeNode*> baseClasses{};
-        auto gd = ScopeGuard<ClassDecl>(new ClassDecl(name, {}));
+        ASTList<ASTTypeNode*> baseClasses{};
+        auto gd = make<ClassDecl>(name, ASTList<ASTTypeNode*> {});
 
         // pre-def for body parsing
-        std::vector<Attribute*> attrs {};
+        AttributeList attrs {};
         ASTModifier md {};
 
         if (check(TokenType::kColon)) {
@@ -801,7 +778,7 @@ do { \
 
     end:
         advance();
-        return gd.getPtr();
+        return gd;
     }
 
     // variable parser
@@ -817,9 +794,9 @@ do { \
         if (!check(TokenType::kIdentifier)) {
             return Result::failure("unexpected token found after var/val : var xxx <--", ERRR());
         }
-        std::string_view name = current().value;
+        NSymbol name = symbol(current());
         advance();
-        auto gd = ScopeGuard(new VarDecl(name, nullptr));
+        auto gd = make<VarDecl>(name, nullptr);
 
         if (check(TokenType::kColon)) {
             // parse type hint
@@ -851,7 +828,7 @@ do { \
             return Result::failure("variable declare without type hint is not allow! var xxx ... <--", ERRR());
         }
 
-        return gd.getPtr();
+        return gd;
     }
 
     // enum parser
@@ -866,10 +843,10 @@ do { \
         if (!check(TokenType::kIdentifier)) {
             return Result::failure("unexpected token after enum token : enum xxx <--", ERRR());
         }
-        std::string_view name = current().value;
+        NSymbol name = symbol(current());
         advance();
 
-        auto gd = ScopeGuard(new EnumDecl(name));
+        auto gd = make<EnumDecl>(name);
 
         if (check(TokenType::kColon)) {
             // parse enum base type
@@ -886,7 +863,7 @@ do { \
                 // head only declare
 
                 advance();
-                return gd.getPtr();
+                return gd;
             }
             else {
                 return Result::failure("unexpected token after enum head declare : enum xxx : xxx ... <--", ERRR());
@@ -900,7 +877,7 @@ do { \
             do {
                 advance();
                 if (check(TokenType::kIdentifier)) {
-                    std::string_view itemName = current().value;
+                    NSymbol itemName = symbol(current());
 
                     advance();
                     if (check(TokenType::kEq)) {
@@ -914,10 +891,10 @@ do { \
                         if (check(TokenType::kComma)) {
                             advance();
                         }
-                        gd->children.push_back(new VarDecl(itemName, nullptr, eas.value()));
+                        gd->children.push_back(make<VarDecl>(itemName, nullptr, eas.value()));
                     }
                     else if (check(TokenType::kComma)) {
-                        gd->children.push_back(new VarDecl(itemName, nullptr));
+                        gd->children.push_back(make<VarDecl>(itemName, nullptr));
                         continue;
                     }
                     else {
@@ -938,7 +915,7 @@ do { \
             return Result::failure("unexpected token after enum head declare : enum xxx ... <--", ERRR());
         }
 
-        return gd.getPtr();
+        return gd;
     }
 
     // field parser
@@ -952,8 +929,8 @@ do { \
         if (!check(TokenType::kIdentifier)) {
             return Result::failure("unexpected token after field keyword : field xxx <--", ERRR());
         }
-        std::string_view name = current().value;
-        auto gd = ScopeGuard(new FieldDecl(name, nullptr));
+        NSymbol name = symbol(current());
+        auto gd = make<FieldDecl>(name, nullptr);
 
         advance();
         if (check(TokenType::kColon)) {
@@ -976,7 +953,7 @@ do { \
             advance();
             // check read function name
             if (check(TokenType::kIdentifier)) {
-                std::string_view funcName = current().value;
+                NSymbol funcName = symbol(current());
                 gd->getFuncName = funcName;
                 advance();
 
@@ -992,7 +969,7 @@ do { \
 
             // check write function name
             if (check(TokenType::kIdentifier)) {
-                std::string_view funcName = current().value;
+                NSymbol funcName = symbol(current());
                 gd->setFuncName = funcName;
                 advance();
 
@@ -1031,7 +1008,7 @@ do { \
             return Result::failure("unexpected token after field's name : field XXX ... <--", ERRR());
         }
 
-        return gd.getPtr();
+        return gd;
     }
 
     Expected<InterfaceDecl*> NParser::parseInterface() {
@@ -1044,8 +1021,8 @@ do { \
         if (!check(TokenType::kIdentifier)) {
             return Result::failure("unexpected token after interface keyword : interface ... <--", ERRR());
         }
-        std::string_view name = current().value;
-        auto gd = ScopeGuard(new InterfaceDecl(name));
+        NSymbol name = symbol(current());
+        auto gd = make<InterfaceDecl>(name);
         advance();
 
         if (check(TokenType::kLBraces)) {
@@ -1062,7 +1039,7 @@ do { \
                 CHECK_ERROR(r);
                 md = r.value();
 
-                std::string_view func_name = current().value;
+                std::string_view func_name = text(current());
                 advance();
 
 
@@ -1075,7 +1052,7 @@ do { \
             return Result::failure("unexpected token after interface's name : interface xxx ... <--", ERRR());
         }
 
-        return gd.getPtr();
+        return gd;
     }
 
     Expected<StructDecl *> NParser::parseStruct() {
@@ -1090,6 +1067,7 @@ do { \
     {
         auto& output = m_args.output;
         output.clearNodes();
+        NArena::Scope arenaScope {output.getArena()};
 
         // parse entry
         auto r = parseRoot();
@@ -1107,6 +1085,7 @@ do { \
     bool NParser::debugParse() {
         auto& output = m_args.output;
         output.clearNodes();
+        NArena::Scope arenaScope {output.getArena()};
 
         // parse entry
         auto r = parseRoot();
@@ -9,6 +9,7 @@
 
 #include "neo/ast/Base.hpp"
 #include "neo/ast/Decl.hpp"
+#include "neo/compiler/ParsedFile.hpp"
 
 namespace neo {
 
@@ -30,7 +31,7 @@ namespace neo {
    } while(false)
 #define APPLY_ATTRIBUTES(V, AT) do { \
         V->attributes = std::move(AT); \
-        AT = std::vector<Attribute*>();\
+        AT = AttributeList();\
     } while(false)
 
 
@@ -49,15 +50,23 @@ namespace neo {
 #endif
 
     private:
-        NToken& current();
-        NToken& peek();
-        NToken& peekPrevious();
-        NToken& advance();
-        NToken& previous();
+        NToken current();
+        NToken peek();
+        NToken peekPrevious();
+        NToken advance();
+        NToken previous();
+        std::string_view text(const NToken&);
+        NSymbol symbol(const NToken&);
         bool match(TokenType);
         bool expect(TokenType);
         bool check(TokenType);
 
+        /// every node is owned by the arena of the file being parsed
+        template <typename T, typename... Args>
+        NE_FORCE_INLINE T* make(Args&&... args) {
+            return m_args.output.getArena().make<T>(std::forward<Args>(args)...);
+        }
+
     private:
         Expected<void> parseRoot();
         
@@ -79,12 +88,12 @@ namespace neo {
 
         Expected<FieldDecl*> parseField();
 
-        Expected<std::vector<Attribute*>> parseAttributes();
+        Expected<AttributeList> parseAttributes();
         Expected<ASTModifier> parseModifier();
 
         Expected<FuncDecl*> parseFunc();
-        Expected<std::vector<VarDecl*>> parseFuncArgs();
-        Expected<std::vector<ASTExpr*>> parseFuncCallArgs();
+        Expected<ASTList<VarDecl*>> parseFuncArgs();
+        Expected<ASTList<ASTExpr*>> parseFuncCallArgs();
 
 
     private:
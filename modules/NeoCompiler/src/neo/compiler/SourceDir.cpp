@@ -5,6 +5,12 @@
 
 #include "neo/base/StringUtils.hpp"
 #include "neo/base/Logger.hpp"
+#include "neo/base/MemStats.hpp"
+#include "neo/base/ThreadPool.hpp"
+#include "neo/base/Trace.hpp"
+#include "neo/compiler/BuildCache.hpp"
+
+#include <algorithm>
 
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -30,18 +36,67 @@ namespace neo {
                 continue;
             auto pth = fs::relative(entry, m_path).string();
             LogDebug("Neo source file : {} / {}", m_path, pth);
-            m_sources.insert({pth, NSourceFile {this, std::move(pth)}});
+            m_sources.emplace_back(this, std::move(pth));
         }
 
+        std::sort(m_sources.begin(), m_sources.end(), [](const NSourceFile& a, const NSourceFile& b) {
+            return a.getRelativePath() < b.getRelativePath();
+        });
         return true;
     }
 
-    bool NSourceDir::compile() {
+    void NSourceDir::scan(NThreadPool& pool, NBuildCache* cache) {
+        m_jobs.clear();
+        m_jobs.resize(m_sources.size());
+
+        for (psize idx = 0; idx < m_sources.size(); idx++) {
+            pool.submit([this, idx, cache] {
+                auto& job = m_jobs[idx];
+                auto& file = m_sources[idx];
+                NE_TRACE_ZONE("Scan", file.getRelativePath());
+                NBuildCache::Entry entry {};
+                if (cache != nullptr && cache->isContentUpToDate(file, &entry)) {
+                    // the manifest knows what the unchanged source imports
+                    job.upToDate = true;
+                    job.result = true;
+                    job.scan.module = std::move(entry.module);
+                    job.scan.imports = std::move(entry.imports);
+                } else if (!NModuleScan::fromFile(file.getPath(), job.scan)) {
+                    // compile reports the unreadable file
+                    LogDebug("Failed to scan {}", file.getRelativePath());
+                }
+            });
+        }
+    }
+
+    void NSourceDir::graph(NModuleGraph& graph) {
+        for (psize idx = 0; idx < m_sources.size(); idx++) {
+            graph.add(*this, idx, std::move(m_jobs[idx].scan));
+        }
+    }
+
+    void NSourceDir::build(psize idx, NBuildCache* cache) {
+        auto& job = m_jobs[idx];
+        NMemStats::FileScope memScope {m_sources[idx].getRelativePath()};
+        job.log.begin();
+        // every import is built by now, so their interface hashes are final
+        if (job.upToDate && cache != nullptr && !cache->hasStaleImports(m_sources[idx])) {
+            LogDebug("Up to date {}", m_sources[idx].getRelativePath());
+        } else {
+            job.upToDate = false;
+            job.result = m_sources[idx].compile(cache);
+        }
+        job.log.end();
+    }
+
+    bool NSourceDir::finish() {
         bool r = false;
 
-        for (auto& [_,f] : m_sources) {
-            r |= f.compile();
+        for (auto& job : m_jobs) {
+            job.log.replay();
+            r |= job.result;
         }
+        m_jobs.clear();
 
         return r;
     }
@@ -3,10 +3,12 @@
 
 #pragma once
 
-#include <unordered_map>
 #include <string>
+#include <vector>
 
 #include <neo/compiler/SourceFile.hpp>
+#include <neo/compiler/ModuleGraph.hpp>
+#include <neo/base/Logger.hpp>
 
 namespace neo {
 
@@ -16,15 +18,41 @@ namespace neo {
         NSourceDir(const char* path);
         ~NSourceDir();
 
+        NSourceDir(NSourceDir&&) = default;
+        NSourceDir& operator=(NSourceDir&&) = default;
+
         bool collect();
-        bool compile();
+        /// read module name and imports of every source on pool, files the cache has up to date are not read.
+        /// Call graph() after the pool drained
+        void scan(class NThreadPool& pool, class NBuildCache* cache = nullptr);
+        /// move the scans into graph, one unit per source
+        void graph(class NModuleGraph& graph);
+        /// compile job of source idx, run once the files it imports are built
+        void build(psize idx, class NBuildCache* cache = nullptr);
+        /// report the finished jobs in path order, call after the pool drained
+        bool finish();
 
         std::string_view getRoot() {
             return m_path;
         }
+        const NSourceFile& getSource(psize idx) const {
+            return m_sources[idx];
+        }
+        psize getSourceCount() const {
+            return m_sources.size();
+        }
 
     private:
-        std::unordered_map<std::string_view, NSourceFile> m_sources;
+        struct CompileJob {
+            NLogCapture log;
+            bool result = false;
+            bool upToDate = false;
+            NModuleScan scan;
+        };
+
+        // sorted by relative path, that is the report order
+        std::vector<NSourceFile> m_sources;
+        std::vector<CompileJob> m_jobs;
         std::string_view m_path;
     };
 }
\ No newline at end of file
@@ -1,15 +1,21 @@
 #include "SourceFile.hpp"
 
 #include "neo/compiler/SourceDir.hpp"
+#include "neo/compiler/BuildCache.hpp"
+#include "neo/compiler/CompileStats.hpp"
+#include "neo/compiler/ModuleFile.hpp"
 #include "neo/compiler/Lexer.hpp"
 #include "neo/compiler/Parser.hpp"
 #include "neo/compiler/ParsedFile.hpp"
+#include "neo/base/Hash.hpp"
 #include "neo/base/Logger.hpp"
 #include "neo/base/StringUtils.hpp"
+#include "neo/base/Timer.hpp"
+#include "neo/base/Trace.hpp"
 #include "DebugOutput.hpp"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -25,35 +31,57 @@ namespace neo {
 
     NSourceFile::~NSourceFile()
     {
-        m_content.clear();
+        m_content.reset();
     }
 
     bool NSourceFile::readAll()
     {
-        std::ifstream stm {};
-        stm.open(getPath());
-        if (!stm.is_open()) {
+        NE_TRACE_ZONE("Read", m_rPath);
+        if (!m_content.loadFile(getPath())) {
             LogError("Failed to read soruce file {}", m_rPath);
             return false;
         }
-        
-        std::string buf {};
-        std::stringstream builder {};
-        while (std::getline(stm, buf)) {
-            builder << buf << '\n';
-        }
-        buf.clear();
-        m_content = builder.str();
+        m_lineStarts.clear();
 
         return true;
     }
 
     std::string_view NSourceFile::getContent() const
     {
-        if (m_content.empty()) {
-            return "";
+        return m_content.view();
+    }
+
+    void NSourceFile::buildLineIndex()
+    {
+        if (!m_lineStarts.empty()) {
+            return;
+        }
+        // memchr is vectorised by the C runtime, so this is a wide scan for '\n'
+        const char* begin = m_content.data();
+        const char* end = begin + m_content.size();
+        m_lineStarts.push_back(0);
+        for (const char* p = begin; p < end; ) {
+            auto* nl = (const char*)std::memchr(p, '\n', end - p);
+            if (nl == nullptr) {
+                break;
+            }
+            p = nl + 1;
+            m_lineStarts.push_back((u32)(p - begin));
         }
-        return m_content;
+    }
+
+    SourceLoc NSourceFile::locate(u32 offset)
+    {
+        buildLineIndex();
+        auto it = std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), offset);
+        psize line = it - m_lineStarts.begin();
+        return SourceLoc { line, offset - m_lineStarts[line - 1] + 1, this };
+    }
+
+    u32 NSourceFile::offsetOf(const SourceLoc& loc)
+    {
+        buildLineIndex();
+        return m_lineStarts[loc.line - 1] + (u32)loc.column - 1;
     }
 
     std::string NSourceFile::getFileName() const
@@ -66,42 +94,131 @@ namespace neo {
         return concatStr(m_dir->getRoot().data(), "//", m_rPath.c_str());
     }
 
-    bool NSourceFile::compile() {
-        if (!readAll()) {
-            return false;
-        }
-
+    bool NSourceFile::parse(NParsedFile& file) {
         NLexer lex {this};
-        if (!lex.lex()) {
-            LogError("Failed to lex file lex.neo");
-            return -1;
+        NTimer t {};
+        {
+            NE_TRACE_ZONE("Lex", m_rPath);
+            if (!lex.lex()) {
+                LogError("Failed to lex file lex.neo");
+                return false;
+            }
+        }
+        t.end();
+        if (NCompileStats::enabled()) {
+            auto& c = NCompileStats::local();
+            c.lexBytes += m_content.size();
+            c.lexNs += t.nanoTime();
+            NCompileStats::countTokens(c, lex.getTokens());
+        }
+        if (NDump::enabled(DumpKind::kTokens)) {
+            NE_TRACE_ZONE("Dump tokens", m_rPath);
+            NBufferOutput out {};
+            lex.debugPrint(out);
+            NDump::submit(DumpKind::kTokens, *this, out.take());
         }
 
-        NFileOutput o {"output_lex.txt"};
-        lex.debugPrint(o);
-
-        NParsedFile file {};
         NParserArgs args {
             .lexer = &lex,
             .file = this,
             .output = file,
-            .langVer = 1,
+            .langVer = kLangVersion,
         };
         NParser parser {args};
+        t.reset();
+        NTraceZone parseZone {"Parse", m_rPath};
 #if NE_DEBUG
-        if (!parser.debugParse()) {
-            return false;
+        bool r = parser.debugParse();
+#else
+        bool r = parser.parse();
+#endif
+        parseZone.end();
+        t.end();
+        if (r && NCompileStats::enabled()) {
+            auto& c = NCompileStats::local();
+            c.parseBytes += m_content.size();
+            c.parseNs += t.nanoTime();
+            NCompileStats::countNodes(c, file.Nodes);
+        }
+        return r;
+    }
+
+    void NSourceFile::storeModule(NBuildCache& cache, NParsedFile& file, u64 mtime, u64 sourceHash) {
+        NE_TRACE_ZONE("Store module", m_rPath);
+        NModuleInfo info = NModuleInfo::fromNodes(file.Nodes);
+
+        // hashed without the source hash, edits that keep the exports keep the interface
+        NMemorySerializer image {};
+        NModuleWriter::build(image, info);
+        NBuildCache::Entry entry {};
+        entry.interfaceHash = hashBytes(image.data(), image.size());
+
+        info.sourceHash = sourceHash;
+        std::string path = cache.artifactPath(*this, ".nmd");
+        if (!NModuleWriter::write(path.c_str(), info)) {
+            return;
         }
-        NConsoleOutput op {};
-        for (const auto &item: file.Nodes) {
-            item->debugPrint(op);
-            op.writeLine("");
+
+        entry.mtime = mtime;
+        entry.size = m_content.size();
+        entry.contentHash = sourceHash;
+        entry.module = std::move(info.name);
+        entry.imports = std::move(info.imports);
+        cache.update(*this, std::move(entry));
+    }
+
+    bool NSourceFile::compile(NBuildCache* cache) {
+        NE_TRACE_ZONE("Compile file", m_rPath);
+        // stamp before reading, an edit during the build then shows up next time
+        u64 mtime = 0;
+        u64 size = 0;
+        if (cache != nullptr) {
+            NBuildCache::fileStamp(getPath(), mtime, size);
         }
-#else
-        if (!parser.parse()) {
+        if (!readAll()) {
             return false;
         }
-#endif
+        if (NCompileStats::enabled()) {
+            NCompileStats::local().files++;
+        }
+
+        NParsedFile file {};
+        u64 sourceHash = 0;
+        if (cache == nullptr) {
+            if (!parse(file)) {
+                return false;
+            }
+        } else {
+            sourceHash = hashBytes(getContent());
+            std::string path = cache->artifactPath(*this, ".nast");
+            NTraceZone loadZone {"Load ast cache", m_rPath};
+            bool hit = file.loadFrom(path.c_str(), sourceHash, this);
+            loadZone.end();
+            if (hit) {
+                LogDebug("Ast cache hit {}", m_rPath);
+            } else {
+                if (!parse(file)) {
+                    return false;
+                }
+                // a failed store only costs the next build a parse
+                NE_TRACE_ZONE("Store ast cache", m_rPath);
+                file.saveTo(path.c_str(), sourceHash, this);
+            }
+        }
+
+        if (NDump::enabled(DumpKind::kAst)) {
+            NE_TRACE_ZONE("Dump ast", m_rPath);
+            NBufferOutput out {};
+            for (const auto &item: file.Nodes) {
+                item->debugPrint(out);
+                out.writeLine("");
+            }
+            NDump::submit(DumpKind::kAst, *this, out.take());
+        }
+
+        if (cache != nullptr) {
+            storeModule(*cache, file, mtime, sourceHash);
+        }
 
         // Symbol collect pass & analyzer pass
 
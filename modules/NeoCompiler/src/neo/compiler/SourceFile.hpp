@@ -1,7 +1,11 @@
 #pragma once
 
 #include "neo/common.hpp"
+#include "neo/diagnose/SourceLoc.hpp"
+#include "neo/base/SourceBuffer.hpp"
+
 #include <string>
+#include <vector>
 
 namespace neo {
 
@@ -11,16 +15,42 @@ namespace neo {
         NSourceFile(class NSourceDir* dir, std::string rPath);
         ~NSourceFile();
 
+        NSourceFile(NSourceFile&&) = default;
+        NSourceFile& operator=(NSourceFile&&) = default;
+
         bool readAll();
+        /// content of the last readAll, followed by NSourceBuffer::kPadding NUL bytes
         std::string_view getContent() const;
         std::string getPath() const;
         std::string getFileName() const;
 
-        bool compile();
+        /// resolve a byte offset into line / column, the line index is built on first use
+        SourceLoc locate(u32 offset);
+        /// inverse of locate, loc must come from this file
+        u32 offsetOf(const SourceLoc& loc);
+
+        const std::string& getRelativePath() const {
+            return m_rPath;
+        }
+
+        /// lex and parse this file, the kinds enabled by --dump go to NDump.
+        /// With a cache the parse result is reused from / stored to a .nast image in it,
+        /// a hit skips lexing so it dumps no tokens. The module interface goes to a .nmd
+        bool compile(class NBuildCache* cache = nullptr);
+
+    public:
+        /// language version the parser is run with
+        static constexpr u32 kLangVersion = 1;
+
+    private:
+        void buildLineIndex();
+        bool parse(class NParsedFile& file);
+        void storeModule(class NBuildCache& cache, class NParsedFile& file, u64 mtime, u64 sourceHash);
 
     private:
         std::string m_rPath;
-        std::string m_content;
+        NSourceBuffer m_content;
+        std::vector<u32> m_lineStarts;
         NSourceDir* m_dir;
     };
 
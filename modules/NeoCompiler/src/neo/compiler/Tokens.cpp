@@ -1,6 +1,9 @@
 #include "Tokens.hpp"
 
-#include <map>
+#include "neo/compiler/SourceFile.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 namespace neo {
 
@@ -113,7 +116,12 @@ namespace neo {
                   "s_typeStrings array size does not match TokenType enum count");
 
 
-    static const std::map<std::string_view, TokenType> s_idTypes{
+    struct NKeyword {
+        std::string_view text;
+        TokenType type;
+    };
+
+    static constexpr NKeyword s_keywords[] = {
             {"var",       TokenType::kVar},
             {"val",       TokenType::kVal},
             {"fun",       TokenType::kFun},
@@ -148,16 +156,72 @@ namespace neo {
             {"break",     TokenType::kBreak},
             {"new",       TokenType::kNew},
             {"extern",    TokenType::kExtern},
-            {"final",     TokenType::kFinal}
+            {"final",     TokenType::kFinal},
     };
 
 
+    // perfect hash over s_keywords keyed on length + first, second and last char.
+    // the multiplier is searched at compile time so every keyword owns a slot
+    constexpr u32 kKeywordSlotBits = 8;
+    constexpr u32 kKeywordSlots = 1u << kKeywordSlotBits;
+
+    NE_FORCE_INLINE constexpr u32 keywordSlot(const char* s, psize len, u32 seed) {
+        u32 key = (u32)len | ((u32)(u8)s[0] << 8) | ((u32)(u8)s[1] << 16) | ((u32)(u8)s[len - 1] << 24);
+        return (key * seed) >> (32 - kKeywordSlotBits);
+    }
+
+    struct NKeywordTable {
+        u32 seed = 0;
+        psize minLen = kMaxPSize;
+        psize maxLen = 0;
+        u8 slots[kKeywordSlots] {};   // index + 1 into s_keywords, 0 = empty
+    };
+
+    static consteval NKeywordTable buildKeywordTable() {
+        NKeywordTable t {};
+        for (const auto& kw : s_keywords) {
+            t.minLen = std::min(t.minLen, kw.text.length());
+            t.maxLen = std::max(t.maxLen, kw.text.length());
+        }
+
+        for (u32 attempt = 0; attempt < 4096; attempt++) {
+            const u32 seed = 0x9E3779B1u + attempt * 2;
+            NKeywordTable r = t;
+            r.seed = seed;
+            bool collide = false;
+            for (u32 i = 0; i < lengthOf(s_keywords) && !collide; i++) {
+                auto& text = s_keywords[i].text;
+                u32 slot = keywordSlot(text.data(), text.length(), seed);
+                collide = r.slots[slot] != 0;
+                r.slots[slot] = (u8)(i + 1);
+            }
+            if (!collide) {
+                return r;
+            }
+        }
+        return t;
+    }
+
+    static constexpr NKeywordTable s_keywordTable = buildKeywordTable();
+    static_assert(s_keywordTable.seed != 0, "no collision-free keyword hash seed found");
+    static_assert(s_keywordTable.minLen >= 2, "keyword hash reads two leading chars");
+
+
     TokenType NToken::checkIdentifier(const std::string_view &c) {
-        std::string_view rc = c.data();
-        if (s_idTypes.find(rc) != s_idTypes.end()) {
-            return s_idTypes.at(rc);
+        const psize len = c.length();
+        if (len < s_keywordTable.minLen || len > s_keywordTable.maxLen) {
+            return TokenType::kUnknown;
+        }
+
+        u8 idx = s_keywordTable.slots[keywordSlot(c.data(), len, s_keywordTable.seed)];
+        if (idx == 0) {
+            return TokenType::kUnknown;
         }
-        return TokenType::kUnknown;
+        const NKeyword& kw = s_keywords[idx - 1];
+        if (kw.text.length() != len || std::memcmp(kw.text.data(), c.data(), len) != 0) {
+            return TokenType::kUnknown;
+        }
+        return kw.type;
     }
 
 
@@ -170,8 +234,10 @@ namespace neo {
     }
 
 
-    std::string NToken::toString() const {
-        return "{ " + std::string(s_typeStrings[(int) type]) + " : " + value + " }";
+    std::string NToken::toString(std::string_view src) const {
+        std::string r {"{ "};
+        r.append(s_typeStrings[(int) type]).append(" : ").append(value(src)).append(" }");
+        return r;
     }
 
 
@@ -180,5 +246,13 @@ namespace neo {
     }
 
 
-    NToken NToken::Invalid{TokenType::kUnknown, ""};
+    SourceLoc NToken::location(NSourceFile* file) const {
+        if (file == nullptr) {
+            return SourceLoc { 0, 0, nullptr };
+        }
+        return file->locate(offset);
+    }
+
+
+    NToken NToken::Invalid{TokenType::kUnknown, 0, 0};
 }
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "neo/common.hpp"
+#include "neo/base/MemStats.hpp"
 
 #include "neo/diagnose/SourceLoc.hpp"
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace neo {
 
     enum class TokenType : u8 {
@@ -117,26 +122,76 @@ namespace neo {
     struct NToken final
     {
         TokenType type;
-        std::string value;
-        psize line;
-        psize cursor;
+        u32 offset;     // span start in the source buffer
+        u32 length;     // span length in bytes
 
         static std::string_view typeString(TokenType);
         static TokenType checkIdentifier(const std::string_view& str);
-        std::string toString() const;
+        std::string toString(std::string_view src) const;
         std::string_view typeString() const;
 
+        /// resolve the token text against the buffer it was lexed from
+        NE_FORCE_INLINE std::string_view value(std::string_view src) const {
+            return std::string_view { src.data() + offset, length };
+        }
+
         bool operator==(const NToken& other) const {
-            return type == other.type && value == other.value;
+            return type == other.type && offset == other.offset && length == other.length;
         }
         bool operator!=(const NToken& other) const {
             return !(*this == other);
         }
 
-        SourceLoc location(NSourceFile* file = nullptr) const {
-            return SourceLoc { line, cursor, file };
-        }
+        /// line / column are resolved from the file's line index, only on diagnostic paths
+        SourceLoc location(NSourceFile* file = nullptr) const;
 
         static NToken Invalid;
     };
+
+
+    /// Token stream stored as parallel arrays.
+    /// Parser lookahead mostly reads types, so those stay densely packed in their own byte array
+    class NTokenList final
+    {
+    public:
+        NE_FORCE_INLINE void push(TokenType type, u32 offset, u32 length) {
+            m_types.push_back(type);
+            m_offsets.push_back(offset);
+            m_lengths.push_back(length);
+        }
+
+        void reserve(psize count) {
+            m_types.reserve(count);
+            m_offsets.reserve(count);
+            m_lengths.reserve(count);
+        }
+
+        void clear() {
+            m_types.clear();
+            m_offsets.clear();
+            m_lengths.clear();
+        }
+
+        NE_FORCE_INLINE psize size() const {
+            return m_types.size();
+        }
+        NE_FORCE_INLINE TokenType type(psize idx) const {
+            return m_types[idx];
+        }
+        NE_FORCE_INLINE NToken at(psize idx) const {
+            return NToken {
+                .type = m_types[idx],
+                .offset = m_offsets[idx],
+                .length = m_lengths[idx],
+            };
+        }
+
+    private:
+        template <typename T>
+        using Column = std::vector<T, NTrackedAllocator<T, MemTag::kTokens>>;
+
+        Column<TokenType> m_types;
+        Column<u32> m_offsets;
+        Column<u32> m_lengths;
+    };
 }
\ No newline at end of file
@@ -4,3 +4,6 @@
 #pragma once
 
 #define NE_USE_RPMALLOC 1
+
+// compiler release, cached build artifacts are only reused by the same release
+#define NE_NEOC_VERSION "0.1.0"
@@ -1,6 +1,7 @@
 #include "Diagnostic.hpp"
 
 #include "neo/base/Logger.hpp"
+#include "neo/compiler/CompileStats.hpp"
 
 namespace neo {
 
@@ -9,6 +10,13 @@ namespace neo {
         m_diagnostics.emplace_back(Diagnostic{ level, loc, message });
         if (level == DiagnosticLevel::kError)
             ++m_errorCount;
+
+        if (NCompileStats::enabled()) {
+            auto& c = NCompileStats::local();
+            c.errors += level == DiagnosticLevel::kError;
+            c.warnings += level == DiagnosticLevel::kWarning;
+            c.notes += level == DiagnosticLevel::kNote;
+        }
     }
 
 
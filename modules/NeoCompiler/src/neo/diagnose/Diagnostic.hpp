@@ -4,6 +4,7 @@
 #include "neo/compiler/SourceFile.hpp"
 #include "neo/compiler/Tokens.hpp"
 #include "neo/base/Assert.hpp"
+#include "neo/base/MemStats.hpp"
 
 #include <vector>
 #include <type_traits>
@@ -28,6 +29,8 @@ namespace neo {
     class DiagnosticCollector
     {
     public:
+        using List = std::vector<Diagnostic, NTrackedAllocator<Diagnostic, MemTag::kDiagnostics>>;
+
         DiagnosticCollector() = default;
 
     public:
@@ -45,13 +48,13 @@ namespace neo {
 
         NE_FORCE_INLINE bool hasError() const { return m_errorCount > 0; }
         NE_FORCE_INLINE int getErrorCount() const { return m_errorCount; }
-        const std::vector<Diagnostic>& diagnostics() const { return m_diagnostics; }
+        const List& diagnostics() const { return m_diagnostics; }
 
         void printAll() const;
         void clear(DiagnosticLevel flags = DiagnosticLevel::kNone);
 
     private:
-        std::vector<Diagnostic> m_diagnostics;
+        List m_diagnostics;
         int m_errorCount = 0;
     };
 
@@ -123,7 +126,7 @@ namespace neo {
 
         static Result success() { return {}; }
         static Result failure(std::string msg) { return Result(std::move(msg)); }
-        static Result failure(std::string msg, DiagnosticCollector* c, NToken& t, NSourceFile* f) {
+        static Result failure(std::string msg, DiagnosticCollector* c, const NToken& t, NSourceFile* f) {
             c->error(t.location(f), msg);
             return Result(std::move(msg));
         }
@@ -153,22 +156,16 @@ namespace neo {
     class Expected 
     {
     public:
+        // pointer values are AST nodes owned by the file arena, never deleted here
         Expected(T value)
-            : m_value(std::move(value)), m_hasError(false), m_got {false} {
+            : m_value(std::move(value)), m_hasError(false) {
         }
         Expected(Result error)
-            : m_result(std::move(error)), m_hasError(error.hasError()), m_got {false} {
+            : m_result(std::move(error)), m_hasError(error.hasError()) {
             if constexpr (std::is_pointer_v<T>) {
                 m_value = nullptr;
             }
         }
-        ~Expected() {
-            if (m_got) return;
-            if constexpr (std::is_pointer_v<T>) {
-                if (!m_value) return;
-                delete m_value;
-            }
-        }
 
         bool hasError() const { return m_hasError; }
         const Result& result() const { return m_result; }
@@ -177,7 +174,6 @@ namespace neo {
         const T& value() const { NE_ASSERT(!m_hasError); return m_value; }
         T& value() { 
             NE_ASSERT(!m_hasError);
-            m_got = true;
             return m_value;
         }
         T& operator->() {
@@ -190,7 +186,6 @@ namespace neo {
         T m_value;
         Result m_result;
         bool m_hasError;
-        bool m_got;
     };
 
 
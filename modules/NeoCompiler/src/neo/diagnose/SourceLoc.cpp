@@ -17,19 +17,60 @@ namespace neo {
     }
 
     void SourceLoc::write(NSerializer* s) const {
-        s->write(line);
-        s->write(column);
-        s->write(file->getPath());
+        if (s->getMode() == SerialMode::kFixed) {
+            s->write(line);
+            s->write(column);
+            s->write(file != nullptr ? file->getPath() : std::string {});
+            return;
+        }
+
+        // nodes are written in source order, lines move by a little and columns
+        // are only close to the previous one on the same line
+        SourceLoc& last = s->lastLoc();
+        i64 lineDelta = (i64)line - (i64)last.line;
+        s->write(lineDelta);
+        s->write(lineDelta == 0 ? (i64)column - (i64)last.column : (i64)column);
+        // the path only when it changed
+        s->write(file == last.file ? (u32)0 : (u32)1);
+        if (file != last.file) {
+            s->write(file != nullptr ? file->getPath() : std::string {});
+        }
+        last = *this;
+    }
+
+    // the path names a file of the writing process, nothing maps it back to an NSourceFile yet,
+    // so it is stepped over and file is left to the caller
+    static void skipPath(NSerializer* s) {
+        psize len = s->readSize();
+        if (len > s->remaining()) {
+            s->overrun();
+            return;
+        }
+        s->setPos(s->getPos() + len);
     }
 
-    void SourceLoc::read(NSerializer* s) const {
-        s->read((u64)line);
-        s->read((u64)column);
-        std::string path;
-        s->read(path);
+    void SourceLoc::read(NSerializer* s) {
+        if (s->getMode() == SerialMode::kFixed) {
+            line = s->readSize();
+            column = s->readSize();
+            skipPath(s);
+            return;
+        }
 
-        (void)path;
-        //TODO use the result
+        SourceLoc& last = s->lastLoc();
+        i64 lineDelta = 0;
+        i64 columnValue = 0;
+        u32 fileChanged = 0;
+        s->read(lineDelta);
+        s->read(columnValue);
+        s->read(fileChanged);
+        if (fileChanged != 0) {
+            skipPath(s);
+        }
+        line = (psize)((i64)last.line + lineDelta);
+        column = (psize)(lineDelta == 0 ? (i64)last.column + columnValue : columnValue);
+        last.line = line;
+        last.column = column;
     }
 
 }
\ No newline at end of file
@@ -7,13 +7,13 @@ namespace neo {
 
     struct SourceLoc
     {
-        psize line;
-        psize column;
-        class NSourceFile* file;
+        psize line = 0;
+        psize column = 0;
+        class NSourceFile* file = nullptr;
 
         std::string toString() const;
         void write(class NSerializer*) const;
-        void read(class NSerializer*) const;
+        void read(class NSerializer*);
     };
     
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "neo/base/Interner.hpp"
+#include "neo/base/MemStats.hpp"
+
+#include <cstdio>
+#include <format>
+#include <string>
+
+using namespace neo;
+
+static int s_failures = 0;
+
+static void check(bool cond, const char* what) {
+    if (!cond) {
+        std::fprintf(stderr, "FAILED : %s\n", what);
+        s_failures++;
+    }
+}
+
+/// a file is charged the text it interns, not the process wide pages, arena blocks and maps it happens to grow
+static void testTinyFileSymbols() {
+    {
+        // big enough to grow pages, arena blocks and the id maps
+        NMemStats::FileScope scope {"big.neo"};
+        for (u32 i = 0; i < 20000; i++) {
+            intern(std::format("big_symbol_{}", i));
+        }
+    }
+
+    const std::string names[] = {"tiny_alpha", "tiny_beta", "tiny_gamma"};
+    i64 own = 0;
+    {
+        NMemStats::FileScope scope {"tiny.neo"};
+        for (auto& name : names) {
+            intern(name);
+            own += (i64)name.size();
+        }
+        // already interned text costs nothing
+        intern("big_symbol_7");
+    }
+
+    check(NMemStats::filePeak("tiny.neo", MemTag::kSymbols) == own, "tiny file symbols equal its own interned bytes");
+    check(NMemStats::filePeak("big.neo", MemTag::kSymbols) < 20000 * 24, "big file symbols stay near its interned bytes");
+    check(NMemStats::current(MemTag::kSymbols) > NMemStats::filePeak("big.neo", MemTag::kSymbols),
+          "global structures are still counted in the totals");
+}
+
+int main() {
+    NMemStats::enable();
+    testTinyFileSymbols();
+    if (s_failures != 0) {
+        return 1;
+    }
+    std::printf("MemStatsTest passed\n");
+    return 0;
+}